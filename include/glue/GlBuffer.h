@@ -18,7 +18,15 @@ public:
         /// Array objects usually contain vertex data, see \ref GlVertexBuffer
         Array,
         /// ElementArray objects contain index data, see \ref GlIndexBuffer
-        ElementArray
+        ElementArray,
+        /// DrawIndirect objects contain draw commands, see \ref GlIndirectBuffer
+        DrawIndirect,
+        /// DispatchIndirect objects contain compute dispatch commands, see \ref GlProgram::dispatchIndirect
+        DispatchIndirect,
+        /// ShaderStorage objects are read and written by shaders through storage blocks, see \ref bindBase
+        ShaderStorage,
+        /// Uniform objects contain the values of uniform blocks, see \ref bindRange and \ref GlUniformRing
+        Uniform
 	};
 
     /// A hint how the buffer will be used
@@ -35,6 +43,27 @@ public:
         DynamicRead
 	};
 
+    /// Access flags for \ref map, can be combined with bitwise or
+    enum MapAccess
+    {
+        /// The mapped memory may be read
+        MapRead = 1 << 0,
+        /// The mapped memory may be written
+        MapWrite = 1 << 1,
+        /// The previous content of the mapped range may be discarded
+        MapInvalidateRange = 1 << 2,
+        /// The previous content of the entire buffer may be discarded
+        MapInvalidateBuffer = 1 << 3,
+        /// Modified ranges must be flushed explicitly with \ref flushRange
+        MapFlushExplicit = 1 << 4,
+        /// The GL does not synchronize pending operations on the buffer before mapping
+        MapUnsynchronized = 1 << 5,
+        /// The buffer may be used by the GPU while it is mapped (requires immutable storage)
+        MapPersistent = 1 << 6,
+        /// Writes to a persistent mapping are visible to the GPU without explicit flushes
+        MapCoherent = 1 << 7
+    };
+
     /** Creates a new, empty buffer of the given type
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGenBuffers.xhtml">glGenBuffers</a>
      */
@@ -64,6 +93,30 @@ public:
      */
     virtual bool isBound() const;
 
+    /**
+     * Binds the buffer to the binding point index of its target, e.g. to the storage block with layout(binding = index).
+     * Also binds the buffer to the target itself. Only valid for indexed targets (ShaderStorage and Uniform).
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindBufferBase.xhtml">glBindBufferBase</a>
+     */
+    void bindBase(unsigned int index);
+
+    /**
+     * Binds size bytes starting at offset to the binding point index of its target.
+     * The offset must be a multiple of the offset alignment of the target, e.g. GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+     * Also binds the buffer to the target itself. Only valid for indexed targets (ShaderStorage and Uniform).
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindBufferRange.xhtml">glBindBufferRange</a>
+     */
+    void bindRange(unsigned int index, size_t offset, size_t size);
+
+    /// Returns the internal OpenGL name of the buffer.
+    unsigned int id() const;
+
+    /// Returns the target of the buffer.
+    Target target() const;
+
+    /// Returns the size in bytes of the currently allocated memory (see \ref setData).
+    size_t size() const;
+
     /**
      * Allocates a block of memory of the given size.
      * If the pointer to data is not zero, the memory block will be initialized with data.
@@ -72,14 +125,38 @@ public:
      * The GlBuffer object will not keep a reference to the data pointer, i.e. it can be deleted anytime.
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferData.xhtml">glBufferData</a>
      */
-    virtual void setData(Usage usage, void* data, size_t size);
+    virtual void setData(Usage usage, const void* data, size_t size);
 
     /**
      * Copies the given data to the buffer.
      * The offset + size must be smaller or equal to the previous allocated size (see \ref setData).
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferSubData.xhtml">glBufferSubData</a>
      */
-	virtual void setSubData(void* data, size_t size, size_t offset);
+	virtual void setSubData(const void* data, size_t size, size_t offset);
+
+    /**
+     * Maps a range of the buffer into the client address space and returns a pointer to it.
+     * The access is a combination of \ref MapAccess flags.
+     * The offset + size must be smaller or equal to the previous allocated size (see \ref setData).
+     * Returns nullptr if the mapping failed.
+     * The buffer must be \ref unmap "unmapped" before it is used by the GL (unless mapped with MapPersistent).
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMapBufferRange.xhtml">glMapBufferRange</a>
+     */
+    virtual void* map(size_t offset, size_t size, unsigned int access);
+
+    /**
+     * Unmaps the buffer. Pointers returned by \ref map become invalid.
+     * Returns false if the content of the buffer became corrupt while it was mapped.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMapBuffer.xhtml">glUnmapBuffer</a>
+     */
+    virtual bool unmap();
+
+    /**
+     * Signals that a range of a buffer mapped with MapFlushExplicit was modified.
+     * The offset is relative to the beginning of the mapped range.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glFlushMappedBufferRange.xhtml">glFlushMappedBufferRange</a>
+     */
+    virtual void flushRange(size_t offset, size_t size);
 
 protected:
 	const Target _target;
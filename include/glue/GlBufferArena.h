@@ -0,0 +1,181 @@
+#ifndef GLBUFFERARENA_H
+#define GLBUFFERARENA_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlBuffer.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * The GlBufferArena class packs many small meshes into a few large buffers.
+ * Instead of one GlBuffer per mesh, the arena allocates large blocks and hands out ranges of them.
+ * Meshes in the same block share a single vertex array, so switching between them only changes the
+ * base vertex and first index of the draw call instead of rebinding buffers and vertex arrays.
+ *
+ * Free ranges of each block are kept in a free list sorted by offset that is coalesced on \ref free.
+ * Allocations are referenced by handles, since \ref compact may move them inside their block.
+ * The arena binds its blocks to the target of the arena when allocating or writing data.
+ *
+ * \code
+ * GlBufferArena vertices(GlBuffer::Target::Array, 16*1024*1024);
+ * GlBufferArena indices(GlBuffer::Target::ElementArray, 4*1024*1024);
+ *
+ * auto v = vertices.allocate(mesh.vertices.size() * sizeof(Vertex), sizeof(Vertex));
+ * vertices.setSubData(v, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+ * auto i = indices.allocate(mesh.indices.size() * sizeof(unsigned int), sizeof(unsigned int));
+ * indices.setSubData(i, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+ *
+ * // one vertex array per block
+ * vao.bind();
+ * vao.setVertexData(vertices.buffer(v), VertexLayout::attributes());
+ * vao.setIndexBuffer(indices.buffer(i), GlIndexBuffer::UINT);
+ * vao.drawElements(GlVertexArray::Primitive::Triangles, mesh.indices.size(),
+ *                  indices.firstElement(i, sizeof(unsigned int)), vertices.firstElement(v, sizeof(Vertex)));
+ * \endcode
+ */
+class GlBufferArena
+{
+public:
+    /// Reference to an allocation in the arena
+    typedef unsigned int Handle;
+
+    /// Handle that does not refer to any allocation
+    static const Handle InvalidHandle;
+
+    /// Memory usage of the arena
+    struct Statistics
+    {
+        size_t capacity;       ///< size of all blocks in bytes
+        size_t used;           ///< size of all allocations in bytes
+        size_t free;           ///< size of all free ranges in bytes (including alignment gaps)
+        size_t largestFree;    ///< size of the largest free range in bytes
+        size_t numFreeRanges;  ///< number of free ranges
+        size_t numAllocations; ///< number of live allocations
+        size_t numBlocks;      ///< number of blocks
+
+        /// 0 if the free memory is one contiguous range, approaches 1 the more it is split up
+        float fragmentation() const;
+    };
+
+    /**
+     * Creates an empty arena.
+     * Blocks have blockSize bytes and are allocated with the given usage on demand.
+     */
+    GlBufferArena(GlBuffer::Target target, size_t blockSize, GlBuffer::Usage usage=GlBuffer::Usage::StaticDraw);
+
+    /**
+     * Deletes all blocks.
+     * All handles and vertex arrays that use the blocks become invalid.
+     */
+    ~GlBufferArena();
+
+    GlBufferArena(const GlBufferArena&) = delete;
+    GlBufferArena& operator=(const GlBufferArena&) = delete;
+
+    /**
+     * Allocates size bytes whose offset is a multiple of alignment.
+     * For vertex data the alignment should be the size of a vertex and for index data the size of an index,
+     * so the offset can be expressed as base vertex or first index (see \ref firstElement).
+     * A new block is allocated if no free range is large enough, allocations larger than the block size get their own block.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferData.xhtml">glBufferData</a>
+     */
+    Handle allocate(size_t size, size_t alignment=16);
+
+    /**
+     * Returns the range of the allocation to the free list of its block.
+     * The content of the range is not modified.
+     */
+    void free(Handle handle);
+
+    /**
+     * Copies size bytes to the allocation, starting at offset bytes from the beginning of the allocation.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferSubData.xhtml">glBufferSubData</a>
+     */
+    void setSubData(Handle handle, const void* data, size_t size, size_t offset=0);
+
+    /**
+     * Returns the block that contains the allocation.
+     */
+    GlBuffer& buffer(Handle handle) const;
+
+    /**
+     * Returns the index of the block that contains the allocation.
+     */
+    unsigned int blockIndex(Handle handle) const;
+
+    /**
+     * Returns the byte offset of the allocation inside its block.
+     * The offset changes if the allocation is moved by \ref compact.
+     */
+    size_t offset(Handle handle) const;
+
+    /**
+     * Returns the size in bytes of the allocation.
+     */
+    size_t size(Handle handle) const;
+
+    /**
+     * Returns the offset of the allocation in elements of elementSize bytes,
+     * i.e. the base vertex for vertex data or the first index for index data.
+     * The allocation must be aligned to elementSize.
+     */
+    size_t firstElement(Handle handle, size_t elementSize) const;
+
+    /**
+     * Returns the number of blocks.
+     */
+    size_t numBlocks() const;
+
+    /**
+     * Returns the block with the given index.
+     */
+    GlBuffer& block(size_t index) const;
+
+    /**
+     * Moves all allocations of fragmented blocks to the beginning of their block, so the free memory of each block is a single range.
+     * The data is copied on the GPU, the blocks (and the vertex arrays referencing them) stay valid.
+     * Offsets of moved allocations change, draw calls must query them again.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glCopyBufferSubData.xhtml">glCopyBufferSubData</a>
+     */
+    void compact();
+
+    /**
+     * Returns the current memory usage of the arena.
+     */
+    Statistics statistics() const;
+
+private:
+    struct Allocation
+    {
+        unsigned int block;
+        size_t offset;
+        size_t size;
+        size_t alignment;
+        bool live;
+    };
+
+    struct Block
+    {
+        std::unique_ptr<GlBuffer> buffer;
+        size_t size;
+        /// free ranges as offset -> size
+        std::map<size_t, size_t> freeRanges;
+    };
+
+    unsigned int addBlock(size_t size);
+    void releaseRange(Block& block, size_t offset, size_t size);
+    void compactBlock(unsigned int index, GlBuffer& scratch);
+    const Allocation& allocation(Handle handle) const;
+
+private:
+    const GlBuffer::Target _target;
+    const size_t _blockSize;
+    const GlBuffer::Usage _usage;
+    std::vector<Block> _blocks;
+    std::vector<Allocation> _allocations;
+    std::vector<Handle> _freeHandles;
+};
+
+#endif // GLBUFFERARENA_H
@@ -0,0 +1,137 @@
+#ifndef GLDEBUG_H
+#define GLDEBUG_H
+
+#include "glue/GlConfig.h"
+
+#include <functional>
+#include <string>
+
+/**
+ * The GlDebug class reports OpenGL errors and warnings through the debug output of KHR_debug (core in GL 4.3).
+ * The GL calls a callback for each message, so errors are reported without calling glGetError after every GL call.
+ * Besides errors the driver also reports performance warnings, e.g. about buffer reallocations or shader recompiles.
+ *
+ * Once debug output is enabled the glGetError checks of GLUE_GL_DEBUG builds are disabled,
+ * they can be turned on again as a sampled fallback with \ref setErrorCheckInterval.
+ * Most drivers only generate messages for debug contexts (e.g. GLFW_OPENGL_DEBUG_CONTEXT).
+ *
+ * \code
+ * GlDebug::enableOutput();
+ * GlDebug::setMinimumSeverity(GlDebug::Severity::Medium);
+ * GlDebug::setFilter(GlDebug::Source::DontCare, GlDebug::Type::Performance, GlDebug::Severity::DontCare, true);
+ * \endcode
+ */
+class GlDebug
+{
+public:
+    /// Origin of a message
+    enum class Source
+    {
+        Api,
+        WindowSystem,
+        ShaderCompiler,
+        ThirdParty,
+        Application,
+        Other,
+        DontCare
+    };
+
+    /// Kind of a message
+    enum class Type
+    {
+        Error,
+        DeprecatedBehavior,
+        UndefinedBehavior,
+        Portability,
+        Performance,
+        Marker,
+        PushGroup,
+        PopGroup,
+        Other,
+        DontCare
+    };
+
+    /// Importance of a message, from most to least important
+    enum class Severity
+    {
+        High,
+        Medium,
+        Low,
+        Notification,
+        DontCare
+    };
+
+    /// A message of the debug output
+    struct Message
+    {
+        Source source;
+        Type type;
+        Severity severity;
+        unsigned int id;
+        std::string text;
+    };
+
+    /// Function that is called for every message that passes the filters
+    typedef std::function<void(const Message&)> Handler;
+
+    /**
+     * Returns true if the current context supports debug output (KHR_debug).
+     */
+    static bool isAvailable();
+
+    /**
+     * Registers the message callback and enables debug output for the current context.
+     * With synchronous output the callback is called by the GL call that caused the message, so it can be found in a debugger.
+     * Asynchronous output is faster, but the callback may be called later and from another thread.
+     * Disables the glGetError checks (see \ref setErrorCheckInterval), the previous interval is restored by \ref disableOutput.
+     * Returns false if debug output is not available.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDebugMessageCallback.xhtml">glDebugMessageCallback</a>
+     */
+    static bool enableOutput(bool synchronous=false);
+
+    /**
+     * Disables debug output for the current context and restores the glGetError check interval that was set before \ref enableOutput.
+     */
+    static void disableOutput();
+
+    /**
+     * Returns true if debug output was enabled with \ref enableOutput.
+     */
+    static bool isOutputEnabled();
+
+    /**
+     * Replaces the handler that receives the messages.
+     * The default handler logs errors and high severity messages as errors and all others as warnings.
+     * Passing nullptr restores the default handler.
+     * The handler must be thread-safe if asynchronous output is used.
+     */
+    static void setHandler(Handler handler);
+
+    /**
+     * Enables or disables the messages that match source, type and severity, DontCare matches any value.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDebugMessageControl.xhtml">glDebugMessageControl</a>
+     */
+    static void setFilter(Source source, Type type, Severity severity, bool enabled);
+
+    /**
+     * Enables all messages of the given severity or a more important one and disables all others.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDebugMessageControl.xhtml">glDebugMessageControl</a>
+     */
+    static void setMinimumSeverity(Severity severity);
+
+    /**
+     * Checks glGetError only after every interval-th GL call in GLUE_GL_DEBUG builds, 0 disables the checks.
+     * The default is 1 (every call), debug output disables the checks while it is enabled.
+     * Each glGetError synchronizes with the driver, sampling the checks keeps the overhead low but
+     * the reported call is not necessarily the one that caused the error.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGetError.xhtml">glGetError</a>
+     */
+    static void setErrorCheckInterval(unsigned int interval);
+
+    /**
+     * Returns the interval of the glGetError checks.
+     */
+    static unsigned int errorCheckInterval();
+};
+
+#endif // GLDEBUG_H
@@ -3,6 +3,7 @@
 
 #include "glue/GlConfig.h"
 #include "glue/GlBuffer.h"
+#include "glue/GlUtils.h"
 
 #include <vector>
 
@@ -31,19 +32,31 @@ public:
      * Sets the buffer data to a list of UCHAR indices.
      * Overrides any existing data in the buffer.
      */
-    void setData(Usage usage, std::vector<unsigned char> i);
+    void setData(Usage usage, const std::vector<unsigned char>& i);
 
     /**
      * Sets the buffer data to a list of USHORT indices.
      * Overrides any existing data in the buffer.
      */
-    void setData(Usage usage, std::vector<unsigned short> i);
+    void setData(Usage usage, const std::vector<unsigned short>& i);
 
     /**
      * Sets the buffer data to a list of UINT indices.
      * Overrides any existing data in the buffer.
      */
-    void setData(Usage usage, std::vector<unsigned int> i);
+    void setData(Usage usage, const std::vector<unsigned int>& i);
+
+    /**
+     * Sets the buffer data to the narrowest index type that can represent all indices.
+     * The indices are scanned for their range, USHORT is used if all indices fit into 16 bits and UINT otherwise.
+     * UCHAR is only used if allowUChar is true, since many drivers handle 8 bit indices slowly.
+     * The indices are converted in a single pass directly into the mapped buffer.
+     * The range of the indices is available afterwards with \ref minIndex and \ref maxIndex (e.g. to validate them against the number of vertices).
+     * Returns the chosen index type.
+     * Overrides any existing data in the buffer.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMapBufferRange.xhtml">glMapBufferRange</a>
+     */
+    IndexType setDataNarrowed(Usage usage, GlUtils::array_view<unsigned int> i, bool allowUChar=false);
 
     /**
      * Returns the current number of indices.
@@ -59,9 +72,28 @@ public:
      */
     IndexType indexType() const;
 
+    /**
+     * Returns the size in bytes of a single index of the given type.
+     */
+    static size_t indexSize(IndexType type);
+
+    /**
+     * Returns the smallest index.
+     * This only returns a meaningful value if the data was set using \ref setDataNarrowed.
+     */
+    unsigned int minIndex() const;
+
+    /**
+     * Returns the largest index.
+     * This only returns a meaningful value if the data was set using \ref setDataNarrowed.
+     */
+    unsigned int maxIndex() const;
+
 private:
     size_t _numIndices;
     IndexType _type;
+    unsigned int _minIndex;
+    unsigned int _maxIndex;
 };
 
 #endif // GLINDEXBUFFER_H
@@ -0,0 +1,104 @@
+#ifndef GLINDIRECTBUFFER_H
+#define GLINDIRECTBUFFER_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlBuffer.h"
+#include "glue/GlUtils.h"
+
+#include <vector>
+
+/**
+ * The GlIndirectBuffer class contains draw commands that are executed by \ref GlVertexArray::multiDrawIndirect
+ * or \ref GlVertexArray::multiDrawElementsIndirect with a single call.
+ * A GlIndirectBuffer is a \ref GlBuffer of type \ref GlBuffer::Target::DrawIndirect.
+ * The commands can also be written by the GPU, e.g. by a compute shader that culls objects.
+ * Without ARB_draw_indirect the commands are only kept on the CPU and drawn one by one.
+ *
+ * \code
+ * std::vector<GlIndirectBuffer::DrawElementsCommand> commands;
+ * for(auto& mesh: meshes)
+ *     commands.push_back({mesh.numIndices, 1, mesh.firstIndex, mesh.baseVertex, 0});
+ * indirect.bind();
+ * indirect.setData(GlBuffer::Usage::DynamicDraw, commands);
+ * vao.multiDrawElementsIndirect(GlVertexArray::Primitive::Triangles, indirect);
+ * \endcode
+ */
+class GlIndirectBuffer : public GlBuffer
+{
+public:
+    /// Parameters of a non-indexed draw, the layout is defined by the GL
+    struct DrawArraysCommand
+    {
+        unsigned int count;         ///< number of vertices
+        unsigned int instanceCount; ///< number of instances
+        unsigned int first;         ///< first vertex
+        unsigned int baseInstance;  ///< first instance of instanced attributes (must be 0 without ARB_base_instance)
+    };
+
+    /// Parameters of an indexed draw, the layout is defined by the GL
+    struct DrawElementsCommand
+    {
+        unsigned int count;         ///< number of indices
+        unsigned int instanceCount; ///< number of instances
+        unsigned int firstIndex;    ///< first index
+        int baseVertex;             ///< value added to each index
+        unsigned int baseInstance;  ///< first instance of instanced attributes (must be 0 without ARB_base_instance)
+    };
+
+    /**
+     * Creates a new, empty indirect buffer.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGenBuffers.xhtml">glGenBuffers</a>
+     */
+    GlIndirectBuffer();
+
+    /**
+     * Binds the buffer to the draw indirect target.
+     * Does nothing without ARB_draw_indirect, since the target does not exist.
+     */
+    void bind() override;
+
+    /**
+     * Unbinds all buffers from the draw indirect target.
+     * Does nothing without ARB_draw_indirect.
+     */
+    void release() override;
+
+    /**
+     * Returns true if the buffer is bound to the draw indirect target, always true without ARB_draw_indirect.
+     */
+    bool isBound() const override;
+
+    /**
+     * Sets the buffer data to a list of non-indexed draw commands.
+     * Overrides any existing data in the buffer.
+     */
+    void setData(Usage usage, GlUtils::array_view<DrawArraysCommand> commands);
+
+    /**
+     * Sets the buffer data to a list of indexed draw commands.
+     * Overrides any existing data in the buffer.
+     */
+    void setData(Usage usage, GlUtils::array_view<DrawElementsCommand> commands);
+
+    /**
+     * Returns the current number of commands.
+     * This only returns meaningful values if the data was set using the setData methods of GlIndirectBuffer
+     * and not setData of GlBuffer.
+     */
+    size_t numCommands() const;
+
+    /**
+     * Returns the CPU copy of the commands that is kept instead of the GL buffer without ARB_draw_indirect,
+     * nullptr if the commands are stored in the GL buffer.
+     */
+    const void* clientCommands() const;
+
+private:
+    void setCommands(Usage usage, const void* data, size_t size, size_t numCommands);
+
+private:
+    size_t _numCommands;
+    std::vector<char> _clientCommands;
+};
+
+#endif // GLINDIRECTBUFFER_H
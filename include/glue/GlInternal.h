@@ -9,6 +9,8 @@
 #include "glue/GlTexture.h"
 #include "glue/GlShader.h"
 #include "glue/GlQuery.h"
+#include "glue/GlDebug.h"
+#include "glue/GlMemoryBarrier.h"
 
 #include "glad/glad.h"
 
@@ -24,6 +26,7 @@
 // avoids including gl.h in every header
 GLenum mapBufferTarget(GlBuffer::Target value);
 GLenum mapBufferUsage(GlBuffer::Usage value);
+GLbitfield mapBufferAccess(unsigned int value);
 GLenum mapVertexAttributeType(GlVertexBuffer::VertexAttribute::Type value);
 GLenum mapVertexArrayPrimitive(GlVertexArray::Primitive value);
 GLenum mapIndexBufferIndexType(GlIndexBuffer::IndexType value);
@@ -37,6 +40,13 @@ GLenum mapShaderType(GlShader::Type value);
 GLint mapMinFilter(GlTexture::MinFilter value);
 GLint mapMagFilter(GlTexture::MagFilter value);
 GLenum mapQueryTarget(GlQuery::Target value);
+GLenum mapDebugSource(GlDebug::Source value);
+GLenum mapDebugType(GlDebug::Type value);
+GLenum mapDebugSeverity(GlDebug::Severity value);
+GLbitfield mapMemoryBarrier(unsigned int value);
+
+// true if objects are modified by name instead of binding them (see GlState::directStateAccess)
+bool useDirectStateAccess();
 
 inline void logGLerror(const char* file, const char* function, int line)
 {
@@ -73,8 +83,21 @@ inline void logGLerror(const char* file, const char* function, int line)
     }
 }
 
+// glGetError is called after every glErrorCheckInterval-th GL call (see GlDebug::setErrorCheckInterval)
+extern unsigned int glErrorCheckInterval;
+extern thread_local unsigned int glErrorCheckCounter;
+
+inline void checkGLerror(const char* file, const char* function, int line)
+{
+    if(glErrorCheckInterval > 0 && ++glErrorCheckCounter >= glErrorCheckInterval)
+    {
+        glErrorCheckCounter = 0;
+        logGLerror(file, function, line);
+    }
+}
+
 #ifdef GLUE_GL_DEBUG
-#define GL_SAFE_CALL(f) f; logGLerror(__FILE__, __PRETTY_FUNCTION__, __LINE__);
+#define GL_SAFE_CALL(f) f; checkGLerror(__FILE__, __PRETTY_FUNCTION__, __LINE__);
 #else
 #define GL_SAFE_CALL(f) f
 #endif
@@ -0,0 +1,63 @@
+#ifndef GLMEMORYBARRIER_H
+#define GLMEMORYBARRIER_H
+
+#include "glue/GlConfig.h"
+
+/**
+ * The GlMemoryBarrier class orders writes of shaders (e.g. of a compute shader into a storage buffer or image)
+ * before later GL operations that read the data. Without a barrier such reads may see stale data.
+ * The bits name the way the data is read afterwards, not the way it was written.
+ *
+ * \code
+ * particles.bindBase(0);
+ * update.dispatchInvocations(numParticles);
+ * GlMemoryBarrier::insert(GlMemoryBarrier::VertexAttribArray);
+ * vao.drawArrays(GlVertexArray::Primitive::Points, 0, numParticles);
+ * \endcode
+ */
+class GlMemoryBarrier
+{
+public:
+    /// Ways in which data written by shaders is read afterwards, can be combined with bitwise or
+    enum Bits
+    {
+        /// Vertex attributes sourced from buffers
+        VertexAttribArray = 1 << 0,
+        /// Indices sourced from buffers
+        ElementArray = 1 << 1,
+        /// Uniform blocks sourced from buffers
+        Uniform = 1 << 2,
+        /// Texture fetches from shaders
+        TextureFetch = 1 << 3,
+        /// Image loads and stores from shaders
+        ShaderImageAccess = 1 << 4,
+        /// Draw and dispatch commands sourced from indirect buffers
+        Command = 1 << 5,
+        /// Pixel transfers from or to buffers
+        PixelBuffer = 1 << 6,
+        /// Texture uploads and downloads
+        TextureUpdate = 1 << 7,
+        /// Buffer uploads, downloads, copies and mappings
+        BufferUpdate = 1 << 8,
+        /// Reads and writes through framebuffers
+        FrameBuffer = 1 << 9,
+        /// Storage block access from shaders
+        ShaderStorage = 1 << 10,
+        /// All of the above
+        All = 0x7ff
+    };
+
+    /**
+     * Returns true if the current context supports memory barriers (GL 4.2 or ARB_shader_image_load_store).
+     */
+    static bool isAvailable();
+
+    /**
+     * Inserts a barrier for the given combination of \ref Bits.
+     * Does nothing if memory barriers are not available.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMemoryBarrier.xhtml">glMemoryBarrier</a>
+     */
+    static void insert(unsigned int bits);
+};
+
+#endif // GLMEMORYBARRIER_H
@@ -0,0 +1,111 @@
+#ifndef GLMESHOPTIMIZER_H
+#define GLMESHOPTIMIZER_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlUtils.h"
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+/**
+ * Reordering of indexed triangle lists before they are uploaded to a \ref GlIndexBuffer.
+ * The functions are independent of the GL and are usually applied in this order:
+ * 1. \ref GlUtils::optimize_vertex_cache reorders triangles so vertices are reused from the post-transform cache.
+ * 2. \ref GlUtils::optimize_overdraw (optional) reorders clusters of triangles so front faces tend to be drawn first.
+ * 3. \ref GlUtils::optimize_vertex_fetch reorders vertices in the order they are used and returns the remap table
+ *    that is applied to all vertex attributes with \ref GlUtils::remap_vertex_attributes.
+ *
+ * \code
+ * std::vector<unsigned int> indices = ...
+ * std::vector<glm::vec3> positions = ...
+ * std::vector<glm::vec3> normals = ...
+ *
+ * GlUtils::optimize_vertex_cache(indices.data(), indices.size(), positions.size());
+ * GlUtils::optimize_overdraw(indices.data(), indices.size(), &positions[0].x, positions.size(), sizeof(glm::vec3));
+ * std::vector<unsigned int> remap;
+ * size_t numVertices = GlUtils::optimize_vertex_fetch(indices.data(), indices.size(), positions.size(), remap);
+ * GlUtils::remap_vertex_attributes(remap, numVertices, positions, normals);
+ *
+ * vbo.setData(GlBuffer::Usage::StaticDraw, positions, normals);
+ * ibo.setDataNarrowed(GlBuffer::Usage::StaticDraw, indices);
+ * \endcode
+ */
+namespace GlUtils
+{
+    /// Marks vertices in a remap table that are not referenced by any index
+    const unsigned int unused_vertex = 0xffffffff;
+
+    /// Result of \ref analyze_vertex_cache
+    struct vertex_cache_stats
+    {
+        size_t transformed; ///< number of vertex shader invocations
+        float acmr;         ///< average cache miss ratio, transformed vertices per triangle (0.5 is optimal for large grids, 3 is the worst case)
+        float atvr;         ///< average transformed vertex ratio, transformed vertices per vertex (1 is optimal)
+    };
+
+    /**
+     * Simulates a FIFO post-transform cache with cacheSize entries for the triangle list.
+     */
+    vertex_cache_stats analyze_vertex_cache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize=16);
+
+    /**
+     * Reorders the triangles of the list in place for post-transform cache locality.
+     * Uses the algorithm of Tom Forsyth ("Linear-Speed Vertex Cache Optimisation") which does not depend on the exact cache size of the GPU.
+     * All indices must be smaller than vertexCount.
+     */
+    void optimize_vertex_cache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+    /**
+     * Reorders clusters of triangles in place to reduce overdraw.
+     * The triangle list should already be optimized with \ref optimize_vertex_cache, clusters start where the
+     * simulated cache misses all vertices of a triangle, so the cache efficiency inside the clusters is preserved.
+     * Clusters facing away from the center of the mesh are drawn first, since they are more likely to occlude other clusters.
+     * The positions are three floats per vertex, positionStride is the distance in bytes between two positions.
+     */
+    void optimize_overdraw(unsigned int* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride);
+
+    /**
+     * Renumbers the vertices in the order they are first referenced by the triangle list to improve the locality of vertex fetches.
+     * The indices are rewritten in place.
+     * remap maps each old vertex to its new position or to \ref unused_vertex if it is not referenced.
+     * Returns the number of referenced vertices.
+     */
+    size_t optimize_vertex_fetch(unsigned int* indices, size_t indexCount, size_t vertexCount, std::vector<unsigned int>& remap);
+
+    /**
+     * Returns the vertex attribute reordered according to a remap table of \ref optimize_vertex_fetch.
+     * Unreferenced vertices are dropped.
+     */
+    template<typename T>
+    std::vector<T> remap_vertices(array_view<T> attribute, const std::vector<unsigned int>& remap, size_t newCount)
+    {
+        assert(attribute.size() == remap.size());
+        std::vector<T> result(newCount);
+        for(size_t v=0; v<remap.size(); ++v)
+        {
+            if(remap[v] != unused_vertex)
+                result[remap[v]] = attribute[v];
+        }
+        return result;
+    }
+
+    inline void remap_vertex_attributes(const std::vector<unsigned int>&, size_t)
+    {
+
+    }
+
+    /**
+     * Reorders all given vertex attributes in place according to a remap table of \ref optimize_vertex_fetch.
+     * Afterwards each attribute has newCount elements.
+     */
+    template<typename T, typename... U>
+    void remap_vertex_attributes(const std::vector<unsigned int>& remap, size_t newCount, std::vector<T>& a0, std::vector<U>&... a)
+    {
+        std::vector<T> remapped = remap_vertices(array_view<T>(a0), remap, newCount);
+        a0.swap(remapped);
+        remap_vertex_attributes(remap, newCount, a...);
+    }
+}
+
+#endif // GLMESHOPTIMIZER_H
@@ -16,15 +16,47 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
 #include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
 
 /**
  * The GlProgram class represents a OpenGL shader program.
- * A program consists of a vertex, fragment and an optional geometry shader.
+ * A program consists of a vertex, fragment and an optional geometry shader, or of a single compute shader.
  * Programs must be successfully \ref link "linked" before it can be used.
+ *
+ * After linking, the active uniforms are enumerated into a hash table, so setting a uniform by name
+ * does not query its location from the driver. Uniforms that are set often should be looked up once with
+ * \ref uniform, setting them by handle does not touch the name at all.
+ *
+ * \code
+ * auto mvp = program.uniform("mvp");                       // or program.uniform(GlUtils::hash_string("mvp"))
+ * program.activate();
+ * for(const auto& object: objects)
+ * {
+ *     program.setUniform(mvp, projection * view * object.model);
+ *     object.draw();
+ * }
+ * \endcode
+ *
+ * The constructors wait until the program is linked. Programs created with \ref submit are compiled and linked
+ * in the background if the driver supports parallel compilation (see \ref GlShader::setMaxCompilerThreads),
+ * so many programs can be built at once:
+ *
+ * \code
+ * std::vector<std::unique_ptr<GlProgram>> programs;
+ * for(const auto& source: sources)
+ *     programs.emplace_back(GlProgram::submit(source.vs, source.fs));
+ * // ... until all programs are ready, e.g. while showing a loading screen
+ * for(auto& program: programs)
+ *     program->finish();
+ * \endcode
  */
 class GlProgram
 {
+    friend class GlProgramCache;
 public:
     /**
      * Creates a new GlProgram from the given vertex and fragment shader sources.
@@ -64,6 +96,24 @@ public:
      */
 	GlProgram(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlGeometryShader> gs, std::shared_ptr<GlFragmentShader> fs);
 
+    /**
+     * Creates a new compute GlProgram from the given compute shader source.
+     * Automatically compiles the shader and links the program.
+     * If the shader fails to compile, a \ref GlShader::compile_exception will be raised.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glCreateProgram.xhtml">glCreateProgram</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glAttachShader.xhtml">glAttachShader</a>
+     */
+    explicit GlProgram(const std::string& cs);
+
+    /**
+     * Creates a new compute GlProgram from the given compute shader.
+     * The shader will be \ref GlShader::compile compiled automatically, if it is not compiled yet.
+     * A \ref GlShader::compile_exception will be raised if compilation fails.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glCreateProgram.xhtml">glCreateProgram</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glAttachShader.xhtml">glAttachShader</a>
+     */
+    explicit GlProgram(std::shared_ptr<GlComputeShader> cs);
+
     /**
      * Creates a new GlProgram by loading the vertex and fragment shader sources from the given files.
      * A std::runtime_error is thrown if the files could not be loaded.
@@ -78,6 +128,55 @@ public:
      */
     static GlProgram* fromFile(const std::string& vs, const std::string& gs, const std::string& fs);
 
+    /**
+     * Creates a new compute GlProgram by loading the compute shader source from the given file.
+     * A std::runtime_error is thrown if the file could not be loaded.
+     * \see GlProgram(const std::string& cs)
+     */
+    static GlProgram* fromFile(const std::string& cs);
+
+    /**
+     * Creates a new GlProgram from the given vertex and fragment shader sources and starts compiling and linking it
+     * without waiting for the result. The program must be \ref finish "finished" before its uniforms can be used.
+     * \see <a href="https://www.khronos.org/registry/OpenGL/extensions/KHR/KHR_parallel_shader_compile.txt">KHR_parallel_shader_compile</a>
+     */
+    static GlProgram* submit(const std::string& vs, const std::string& fs);
+
+    /**
+     * Creates a new GlProgram from the given vertex, geometry and fragment shader sources and starts compiling and
+     * linking it without waiting for the result.
+     * \see submit(const std::string& vs, const std::string& fs)
+     */
+    static GlProgram* submit(const std::string& vs, const std::string& gs, const std::string& fs);
+
+    /**
+     * Creates a new GlProgram from the given shaders and starts compiling and linking it without waiting for the result.
+     * Shaders that were already compiled or submitted are not compiled again.
+     * \see submit(const std::string& vs, const std::string& fs)
+     */
+    static GlProgram* submit(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlGeometryShader> gs, std::shared_ptr<GlFragmentShader> fs);
+
+    /**
+     * Creates a new compute GlProgram from the given shader and starts compiling and linking it without waiting for the result.
+     * \see submit(const std::string& vs, const std::string& fs)
+     */
+    static GlProgram* submit(std::shared_ptr<GlComputeShader> cs);
+
+    /**
+     * Returns true if a submitted program has finished compiling and linking, so \ref finish does not block.
+     * Always returns true if the driver does not support parallel compilation.
+     * \see <a href="https://www.khronos.org/registry/OpenGL/extensions/KHR/KHR_parallel_shader_compile.txt">GL_COMPLETION_STATUS_KHR</a>
+     */
+    bool isReady() const;
+
+    /**
+     * Waits until a submitted program is linked and enumerates its uniforms.
+     * A \ref GlShader::compile_exception is raised if a shader failed to compile.
+     * Returns true if the linking was successfull, false otherwise. Logs are only fetched on failure.
+     * \ref activate finishes the program automatically.
+     */
+    bool finish();
+
     /**
      * Returns the current vertex shader.
      */
@@ -93,9 +192,15 @@ public:
      */
 	std::shared_ptr<GlFragmentShader> fragmentShader() const;
 
+    /**
+     * Returns the current compute shader if any.
+     */
+    std::shared_ptr<GlComputeShader> computeShader() const;
+
     /**
      * Links the shaders to a program.
-     * Shaders must be successfully compiled before.
+     * Shaders that were not compiled yet (e.g. of a program restored by \ref GlProgramCache) are compiled first,
+     * a \ref GlShader::compile_exception is raised if that fails.
      * Returns true if the linking was successfull, false otherwise.
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glLinkProgram.xhtml">glLinkProgram</a>
      */
@@ -120,6 +225,42 @@ public:
      */
 	void deactivate();
 
+    /// Number of work groups of an indirect dispatch, the layout is defined by the GL
+    struct DispatchCommand
+    {
+        unsigned int x;
+        unsigned int y;
+        unsigned int z;
+    };
+
+    /**
+     * Returns the local work group size of a compute program, i.e. the local_size_x/y/z layout of the shader.
+     * Returns zeros for other programs.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGetProgram.xhtml">GL_COMPUTE_WORK_GROUP_SIZE</a>
+     */
+    std::array<unsigned int, 3> workGroupSize() const;
+
+    /**
+     * Activates the compute program and launches x * y * z work groups.
+     * Results must be made visible with a \ref GlMemoryBarrier before they are read.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDispatchCompute.xhtml">glDispatchCompute</a>
+     */
+    void dispatch(unsigned int x, unsigned int y=1, unsigned int z=1);
+
+    /**
+     * Activates the compute program and launches enough work groups for at least x * y * z invocations,
+     * based on the \ref workGroupSize. The shader must ignore the invocations outside of the range.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDispatchCompute.xhtml">glDispatchCompute</a>
+     */
+    void dispatchInvocations(unsigned int x, unsigned int y=1, unsigned int z=1);
+
+    /**
+     * Activates the compute program and launches the work groups given by the \ref DispatchCommand at offset
+     * in buffer. The buffer must have the target \ref GlBuffer::Target::DispatchIndirect and is bound by this call.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDispatchComputeIndirect.xhtml">glDispatchComputeIndirect</a>
+     */
+    void dispatchIndirect(GlBuffer& buffer, size_t offset=0);
+
     /**
      * Binds a user-defined varying out variable of the fragment shader to a color channel.
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindFragDataLocation.xhtml">glBindFragDataLocation</a>
@@ -140,6 +281,109 @@ public:
      */
     int getUniformLocation(const std::string& name);
 
+    /// Reflection data of an active uniform
+    struct UniformInfo
+    {
+        std::string name;  ///< name of the uniform, without "[0]" for arrays
+        unsigned int type; ///< GL type, e.g. GL_FLOAT_VEC3
+        int size;          ///< number of array elements, 1 if the uniform is not an array
+        int location;      ///< location of the (first) element, -1 for members of uniform blocks
+    };
+
+    /// Reference to an active uniform of a program, obtained with \ref uniform
+    struct UniformHandle
+    {
+        unsigned int index;
+        int location;
+
+        /// Creates an invalid handle
+        UniformHandle(): index(0xffffffff), location(-1) {}
+
+        /// Returns false if the uniform was not found
+        bool isValid() const { return index != 0xffffffff; }
+    };
+
+    /**
+     * Returns the active uniforms of the last successful \ref link.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGetActiveUniform.xhtml">glGetActiveUniform</a>
+     */
+    const std::vector<UniformInfo>& uniforms() const;
+
+    /**
+     * Returns a handle to the active uniform with the given name.
+     * Array uniforms are found by their name with or without "[0]".
+     * The handle is invalid if the uniform does not exist and must be looked up again after linking.
+     */
+    UniformHandle uniform(const std::string& name) const;
+
+    /**
+     * Returns a handle to the active uniform whose name has the given \ref GlUtils::hash_string "hash".
+     * Hashes of literals are computed at compile time, so no string is processed at all.
+     */
+    UniformHandle uniform(uint32_t nameHash) const;
+
+    /**
+     * Returns the reflection data of the uniform.
+     */
+    const UniformInfo& uniformInfo(UniformHandle uniform) const;
+
+    /// Reflection data of an active uniform block
+    struct UniformBlockInfo
+    {
+        std::string name;     ///< name of the block
+        unsigned int index;   ///< index of the block in the program
+        size_t size;          ///< minimum size in bytes of the buffer range bound to the block
+        unsigned int binding; ///< binding point of the block, see \ref setUniformBlockBinding
+    };
+
+    /**
+     * Returns the active uniform blocks of the last successful \ref link.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGetActiveUniformBlock.xhtml">glGetActiveUniformBlock</a>
+     */
+    const std::vector<UniformBlockInfo>& uniformBlocks() const;
+
+    /**
+     * Returns the index of the active uniform block with the given name, -1 if there is no such block.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGetUniformBlockIndex.xhtml">glGetUniformBlockIndex</a>
+     */
+    int uniformBlockIndex(const std::string& name) const;
+
+    /**
+     * Connects the uniform block with the given name to a binding point of \ref GlBuffer::Target::Uniform buffers.
+     * Programs that use the same binding for a block share the buffer range bound there, e.g. with \ref GlUniformRing.
+     * Does nothing if the block is already connected to the binding.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniformBlockBinding.xhtml">glUniformBlockBinding</a>
+     */
+    void setUniformBlockBinding(const std::string& name, unsigned int binding);
+
+    /**
+     * Connects the uniform block with the given index to a binding point of \ref GlBuffer::Target::Uniform buffers.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniformBlockBinding.xhtml">glUniformBlockBinding</a>
+     */
+    void setUniformBlockBinding(unsigned int blockIndex, unsigned int binding);
+
+    /// Number of glUniform calls that were issued and skipped because the value did not change
+    struct UniformStatistics
+    {
+        size_t issued;
+        size_t skipped;
+    };
+
+    /**
+     * Returns the number of issued and skipped uniform updates since the last reset.
+     * The setters keep a copy of the last value written to each location and skip glUniform if it is unchanged.
+     */
+    UniformStatistics uniformStatistics() const;
+
+    /// Resets the counters of \ref uniformStatistics.
+    void resetUniformStatistics();
+
+    /**
+     * Forgets the last written uniform values, so the next update of each uniform is issued.
+     * Must be called if uniforms of the program are changed without GlProgram, e.g. by calling glUniform directly.
+     */
+    void invalidateUniformCache();
+
     /**
      * \name Uniforms
      * Sets a uniform with the given name to the given value.
@@ -158,6 +402,18 @@ public:
     void setUniform(const std::string& name, const glm::mat4 &value);
     /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3f</a>
     void setUniform(const std::string& name, const glm::vec3 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2fv</a>
+    void setUniform(const std::string& name, const glm::vec2 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4fv</a>
+    void setUniform(const std::string& name, const glm::vec4 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix3fv</a>
+    void setUniform(const std::string& name, const glm::mat3 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2iv</a>
+    void setUniform(const std::string& name, const glm::ivec2 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3iv</a>
+    void setUniform(const std::string& name, const glm::ivec3 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4iv</a>
+    void setUniform(const std::string& name, const glm::ivec4 &value);
 #endif
 #ifdef GLUE_QT
     /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2f</a>
@@ -167,22 +423,162 @@ public:
     /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4f</a>
     void setUniform(const std::string& name, const QVector4D &value);
     /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix3fv</a>
-    void setUniform(const std::string& name, const QMatrix3x3 &value);
+    void setUniform(const std::string& name, const QMatrix3x3 &value, bool transpose=false);
     /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
-    void setUniform(const std::string& name, const QMatrix4x4 &value);
+    void setUniform(const std::string& name, const QMatrix4x4 &value, bool transpose=false);
     /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4f</a>
     void setUniform(const std::string& name, const QColor &value);
 #endif
     ///@}
 
+    /**
+     * \name Uniforms by handle
+     * Sets the uniform referenced by a handle of this program to the given value.
+     * Does nothing if the handle is invalid.
+     */
+    ///@{
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1i</a>
+    void setUniform(UniformHandle uniform, int value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1f</a>
+    void setUniform(UniformHandle uniform, float value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1f</a>
+    void setUniform(UniformHandle uniform, double value);
+#ifdef GLUE_GLM
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
+    void setUniform(UniformHandle uniform, const glm::mat4 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3f</a>
+    void setUniform(UniformHandle uniform, const glm::vec3 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2fv</a>
+    void setUniform(UniformHandle uniform, const glm::vec2 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4fv</a>
+    void setUniform(UniformHandle uniform, const glm::vec4 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix3fv</a>
+    void setUniform(UniformHandle uniform, const glm::mat3 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2iv</a>
+    void setUniform(UniformHandle uniform, const glm::ivec2 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3iv</a>
+    void setUniform(UniformHandle uniform, const glm::ivec3 &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4iv</a>
+    void setUniform(UniformHandle uniform, const glm::ivec4 &value);
+#endif
+#ifdef GLUE_QT
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2f</a>
+    void setUniform(UniformHandle uniform, const QVector2D &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3f</a>
+    void setUniform(UniformHandle uniform, const QVector3D &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4f</a>
+    void setUniform(UniformHandle uniform, const QVector4D &value);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix3fv</a>
+    void setUniform(UniformHandle uniform, const QMatrix3x3 &value, bool transpose=false);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
+    void setUniform(UniformHandle uniform, const QMatrix4x4 &value, bool transpose=false);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4f</a>
+    void setUniform(UniformHandle uniform, const QColor &value);
+#endif
+    ///@}
+
+    /**
+     * \name Array uniforms
+     * Sets the elements of an array uniform, starting with the first element, in a single call.
+     * The values are passed as \ref GlUtils::array_view, i.e. a std::vector or \ref GlUtils::make_view "pointer and count".
+     * Does nothing if the array is empty or the uniform does not exist.
+     */
+    ///@{
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<float> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1iv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<int> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1uiv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<unsigned int> values);
+#ifdef GLUE_GLM
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::vec2> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::vec3> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::vec4> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2iv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::ivec2> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3iv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::ivec3> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4iv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::ivec4> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix3fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::mat3> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<glm::mat4> values);
+#endif
+#ifdef GLUE_QT
+    /// Transposes the matrices if transpose is true. \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
+    void setUniform(const std::string& name, GlUtils::array_view<QMatrix4x4> values, bool transpose=false);
+#endif
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<float> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1iv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<int> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform1uiv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<unsigned int> values);
+#ifdef GLUE_GLM
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::vec2> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::vec3> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::vec4> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform2iv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::ivec2> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform3iv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::ivec3> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniform4iv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::ivec4> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix3fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::mat3> values);
+    /// \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<glm::mat4> values);
+#endif
+#ifdef GLUE_QT
+    /// Transposes the matrices if transpose is true. \see <a href="https://www.opengl.org/sdk/docs/man/html/glUniform.xhtml">glUniformMatrix4fv</a>
+    void setUniform(UniformHandle uniform, GlUtils::array_view<QMatrix4x4> values, bool transpose=false);
+#endif
+    ///@}
+
 private:
+    /// creates the program and attaches the shaders, startBuild() compiles and links them
+    GlProgram(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlGeometryShader> gs, std::shared_ptr<GlFragmentShader> fs,
+              std::shared_ptr<GlComputeShader> cs, bool build);
+    void startBuild(bool retrievable);
+    bool checkLink();
+    bool loadBinary(unsigned int format, const void* data, size_t size);
+    bool binary(unsigned int& format, std::vector<char>& data) const;
     static std::string loadFile(const std::string& filepath);
+    void reflectUniforms();
+    void reflectWorkGroupSize();
+    void reflectUniformBlocks();
+    void insertUniform(uint32_t hash, unsigned int index);
+    unsigned int findUniform(uint32_t hash) const;
+    UniformHandle namedUniform(const std::string& name);
+    bool updateUniform(int location, const void* data, size_t size);
 
 private:
     unsigned int _id;
+    std::vector<UniformInfo> _uniforms;
+    std::vector<UniformBlockInfo> _uniformBlocks;
+    /// open addressing hash table of (name hash, uniform index), the size is a power of two
+    std::vector<std::pair<uint32_t, unsigned int>> _uniformTable;
+    /// last written value of each uniform location as offset into _uniformValues and number of bytes until the end of the uniform
+    std::vector<std::pair<uint32_t, uint32_t>> _uniformSlots;
+    std::vector<unsigned char> _uniformValues;
+    /// non-zero for bytes of _uniformValues that were written
+    std::vector<unsigned char> _uniformKnown;
+    UniformStatistics _uniformStatistics;
 	std::shared_ptr<GlVertexShader> _vs;
 	std::shared_ptr<GlGeometryShader> _gs;
 	std::shared_ptr<GlFragmentShader> _fs;
+    std::shared_ptr<GlComputeShader> _cs;
+    std::array<unsigned int, 3> _workGroupSize;
+    /// the program was submitted with glLinkProgram but its status was not checked yet
+    bool _pending;
+    bool _linked;
 };
 
 namespace GlUtils
@@ -0,0 +1,98 @@
+#ifndef GLPROGRAMCACHE_H
+#define GLPROGRAMCACHE_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlProgram.h"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * The GlProgramCache class stores linked programs as driver binaries in a directory,
+ * so later runs restore them with glProgramBinary instead of compiling and linking the shaders again.
+ *
+ * Each binary is keyed by a hash of the shader sources and the vendor, renderer and version strings of the context.
+ * A driver update therefore results in a new key. If the driver rejects a binary anyway, the program is
+ * compiled and linked normally and the binary is replaced.
+ * The shaders of a restored program are not compiled, they are only compiled if the program is linked again.
+ *
+ * Without ARB_get_program_binary (core in GL 4.1) or if the driver supports no binary formats,
+ * the cache simply compiles and links the programs.
+ *
+ * \code
+ * GlProgramCache cache("shader_cache");
+ * std::unique_ptr<GlProgram> program(cache.fromFile("mesh.vert", "mesh.frag"));
+ * \endcode
+ */
+class GlProgramCache
+{
+public:
+    /// Number of programs that were restored, compiled because no binary was stored and compiled because the binary was rejected
+    struct Statistics
+    {
+        size_t hits;
+        size_t misses;
+        size_t rejected;
+    };
+
+    /**
+     * Creates a cache that stores the binaries in directory.
+     * The directory is created if it does not exist, its parent directory must exist.
+     */
+    explicit GlProgramCache(const std::string& directory);
+
+    /**
+     * Returns the program of the given vertex and fragment shader sources.
+     * A \ref GlShader::compile_exception is raised if the program is not cached and compilation fails.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glProgramBinary.xhtml">glProgramBinary</a>
+     */
+    GlProgram* load(const std::string& vs, const std::string& fs);
+
+    /**
+     * Returns the program of the given vertex, geometry and fragment shader sources.
+     * A \ref GlShader::compile_exception is raised if the program is not cached and compilation fails.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glProgramBinary.xhtml">glProgramBinary</a>
+     */
+    GlProgram* load(const std::string& vs, const std::string& gs, const std::string& fs);
+
+    /**
+     * Loads the vertex and fragment shader sources from the given files and returns their program.
+     * A std::runtime_error is thrown if the files could not be loaded.
+     */
+    GlProgram* fromFile(const std::string& vs, const std::string& fs);
+
+    /**
+     * Loads the vertex, geometry and fragment shader sources from the given files and returns their program.
+     * A std::runtime_error is thrown if the files could not be loaded.
+     */
+    GlProgram* fromFile(const std::string& vs, const std::string& gs, const std::string& fs);
+
+    /**
+     * Returns true if the context can store program binaries.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGet.xhtml">GL_NUM_PROGRAM_BINARY_FORMATS</a>
+     */
+    bool isAvailable() const;
+
+    /**
+     * Returns the number of cache hits, misses and rejected binaries.
+     */
+    Statistics statistics() const;
+
+private:
+    GlProgram* load(const std::string& vs, const std::string* gs, const std::string& fs);
+    void finish(GlProgram* program) const;
+    uint64_t key(const std::string& vs, const std::string* gs, const std::string& fs) const;
+    std::string path(uint64_t key) const;
+    bool read(uint64_t key, GlProgram& program);
+    void write(uint64_t key, const GlProgram& program) const;
+
+private:
+    std::string _directory;
+    /// hash of vendor, renderer and version, 0 until the first program is loaded
+    mutable uint64_t _contextHash;
+    mutable int _available;
+    Statistics _statistics;
+};
+
+#endif // GLPROGRAMCACHE_H
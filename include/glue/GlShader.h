@@ -26,7 +26,8 @@ public:
 	{
         VertexShader,
         GeometryShader,
-        FragmentShader
+        FragmentShader,
+        ComputeShader
 	};
 
     /**
@@ -56,6 +57,32 @@ public:
      */
 	void compile();
 
+    /**
+     * Starts compiling the shader source that was set before without waiting for the result.
+     * Does nothing if the current source was already submitted.
+     * Errors are reported when the shader is used, e.g. by \ref GlProgram::finish.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glCompileShader.xhtml">glCompileShader</a>
+     */
+    void submit();
+
+    /**
+     * Returns true if the current source was submitted for compilation.
+     */
+    bool isSubmitted() const;
+
+    /**
+     * Returns true if the driver can compile shaders and link programs on multiple threads
+     * (KHR_parallel_shader_compile or ARB_parallel_shader_compile).
+     */
+    static bool isParallelCompileAvailable();
+
+    /**
+     * Sets the number of threads the driver may use to compile shaders and link programs, 0 compiles synchronously.
+     * Does nothing if parallel compilation is not available.
+     * \see <a href="https://www.khronos.org/registry/OpenGL/extensions/KHR/KHR_parallel_shader_compile.txt">glMaxShaderCompilerThreadsKHR</a>
+     */
+    static void setMaxCompilerThreads(unsigned int count);
+
     /**
      * Returns the compile log of the last compilation.
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGetShaderInfoLog.xhtml">glGetShaderInfoLog</a>
@@ -71,6 +98,7 @@ public:
 protected:
 	Type _type;
     unsigned int _id;
+    bool _submitted;
 };
 
 /**
@@ -100,6 +128,16 @@ public:
     GlFragmentShader(const std::string& source);
 };
 
+/**
+ * The GlComputeShader class represents a compute shader.
+ * Compute shaders require GL 4.3 or ARB_compute_shader.
+ */
+class GlComputeShader: public GlShader
+{
+public:
+    GlComputeShader(const std::string& source);
+};
+
 
 
 #endif // GLSHADER_H
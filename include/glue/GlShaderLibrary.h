@@ -0,0 +1,121 @@
+#ifndef GLSHADERLIBRARY_H
+#define GLSHADERLIBRARY_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlShader.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * The GlShaderLibrary class builds shader variants from a common source.
+ * The source may include other files with #include "name", and each variant injects its own set of #defines
+ * after the #version line. Includes are resolved from the sources added with \ref addInclude first,
+ * then relative to the include directory. #line directives keep the line numbers of compile errors correct,
+ * the source string number of an included file is its position in the order of first inclusion.
+ *
+ * Variants are cached by a hash of the stage, the source and the defines, so requesting the same variant again
+ * returns the shader that was already created instead of compiling a duplicate. New variants are submitted for
+ * compilation immediately, see \ref GlShader::submit.
+ *
+ * \code
+ * GlShaderLibrary library("shaders/");
+ * auto vs = library.vertexShader(meshSource, {{"SKINNING", "1"}, {"NUM_LIGHTS", "4"}});
+ * auto fs = library.fragmentShader(litSource, {{"NUM_LIGHTS", "4"}, {"FOG", ""}});
+ * GlProgram program(vs, fs);
+ * \endcode
+ */
+class GlShaderLibrary
+{
+public:
+    /// Preprocessor definitions as name and value, the order does not matter
+    typedef std::vector<std::pair<std::string, std::string>> Defines;
+
+    /// Number of variants that were found in the cache and that were created
+    struct Statistics
+    {
+        size_t hits;
+        size_t misses;
+    };
+
+    /**
+     * Creates an empty library that resolves includes relative to includeDirectory.
+     */
+    explicit GlShaderLibrary(const std::string& includeDirectory = "");
+
+    /**
+     * Adds a source that can be included with #include "name" without reading a file.
+     * Variants that already include name are not updated, see \ref clear.
+     */
+    void addInclude(const std::string& name, const std::string& source);
+
+    /**
+     * Resolves the includes of source and injects the defines.
+     * A std::runtime_error is thrown if an include could not be found or includes itself.
+     */
+    std::string preprocess(const std::string& source, const Defines& defines = Defines()) const;
+
+    /**
+     * Returns the vertex shader variant of source with the given defines.
+     * A std::runtime_error is thrown if the source could not be preprocessed.
+     */
+    std::shared_ptr<GlVertexShader> vertexShader(const std::string& source, const Defines& defines = Defines());
+
+    /**
+     * Returns the geometry shader variant of source with the given defines.
+     * A std::runtime_error is thrown if the source could not be preprocessed.
+     */
+    std::shared_ptr<GlGeometryShader> geometryShader(const std::string& source, const Defines& defines = Defines());
+
+    /**
+     * Returns the fragment shader variant of source with the given defines.
+     * A std::runtime_error is thrown if the source could not be preprocessed.
+     */
+    std::shared_ptr<GlFragmentShader> fragmentShader(const std::string& source, const Defines& defines = Defines());
+
+    /**
+     * Returns the compute shader variant of source with the given defines.
+     * A std::runtime_error is thrown if the source could not be preprocessed.
+     */
+    std::shared_ptr<GlComputeShader> computeShader(const std::string& source, const Defines& defines = Defines());
+
+    /**
+     * Returns the number of cached variants.
+     */
+    size_t size() const;
+
+    /**
+     * Removes the variants that are not used by any program or other owner and returns their number.
+     * Calling this e.g. after loading a level bounds the memory of variants that were only needed once.
+     */
+    size_t collect();
+
+    /**
+     * Removes all variants from the cache. Shaders that are still used stay valid.
+     */
+    void clear();
+
+    /**
+     * Returns the number of cache hits and misses.
+     */
+    Statistics statistics() const;
+
+private:
+    template<class T>
+    std::shared_ptr<T> variant(GlShader::Type type, const std::string& source, const Defines& defines);
+    void expand(const std::string& source, unsigned int sourceNumber, unsigned int firstLine, std::vector<std::string>& stack,
+                std::vector<std::string>& included, std::string& out) const;
+    std::string include(const std::string& name) const;
+
+private:
+    std::string _includeDirectory;
+    std::unordered_map<std::string, std::string> _includes;
+    std::unordered_map<uint64_t, std::shared_ptr<GlShader>> _variants;
+    Statistics _statistics;
+};
+
+#endif // GLSHADERLIBRARY_H
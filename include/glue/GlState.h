@@ -0,0 +1,230 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlBuffer.h"
+#include "glue/GlTexture.h"
+#include "glue/GlFrameBuffer.h"
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * The GlState class shadows the object bindings of an OpenGL context on the CPU.
+ * All glue classes bind objects through the state of the current context, so binding an object
+ * that is already bound does not reach the driver and isBound() is answered without glGet queries.
+ *
+ * Bindings are unknown until they are set or queried once. Code that changes bindings without glue
+ * (e.g. other libraries) must call \ref invalidate afterwards.
+ * In verify mode every cached answer is compared with the GL and mismatches are logged.
+ *
+ * If the context supports direct state access (GL 4.5 or ARB_direct_state_access), glue modifies objects
+ * by name and only binds them to use them, e.g. buffers and textures can be filled without binding them.
+ *
+ * Each context needs its own state. By default every thread has one state,
+ * applications that use multiple contexts on one thread switch the state together with the context.
+ *
+ * \code
+ * GlState state;
+ * glfwMakeContextCurrent(window);
+ * GlState::setCurrent(&state);
+ * \endcode
+ */
+class GlState
+{
+public:
+    /// Number of GL calls that were issued and skipped because the binding did not change
+    struct Statistics
+    {
+        size_t issued;
+        size_t skipped;
+    };
+
+    /**
+     * Creates a state with unknown bindings.
+     */
+    GlState();
+
+    /**
+     * Returns the state of the current context.
+     */
+    static GlState& current();
+
+    /**
+     * Makes state the state of the current context (on this thread).
+     * Passing nullptr restores the default state of the thread.
+     */
+    static void setCurrent(GlState* state);
+
+    /**
+     * Forgets all cached bindings, they are queried again when needed.
+     */
+    void invalidate();
+
+    /**
+     * Enables cross-checking every cached binding with the GL.
+     * Mismatches are logged as errors. This is as slow as not caching at all and only meant for debugging.
+     */
+    void setVerify(bool verify);
+
+    /**
+     * Returns true if verify mode is enabled.
+     */
+    bool verify() const;
+
+    /**
+     * Returns the number of issued and skipped bind calls.
+     */
+    Statistics statistics() const;
+
+    /**
+     * Returns true if glue uses direct state access to modify objects.
+     * Objects then only need to be bound to use them, not to change their data or parameters.
+     */
+    bool directStateAccess() const;
+
+    /**
+     * Allows to disable direct state access, e.g. to test the bind-based path.
+     * Enabling it has no effect if the context does not support it.
+     * Must be set before objects are created, since objects created without direct state access
+     * can only be modified by name after they were bound once.
+     */
+    void setDirectStateAccess(bool enable);
+
+    /**
+     * Binds the buffer with the given id to target, unless it is already bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindBuffer.xhtml">glBindBuffer</a>
+     */
+    void bindBuffer(GlBuffer::Target target, unsigned int id);
+
+    /**
+     * Binds the buffer with the given id to the binding point index of target and to target itself,
+     * unless it is already bound to the binding point.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindBufferBase.xhtml">glBindBufferBase</a>
+     */
+    void bindBufferBase(GlBuffer::Target target, unsigned int index, unsigned int id);
+
+    /**
+     * Binds a range of the buffer with the given id to the binding point index of target and to target itself,
+     * unless the same range is already bound to the binding point.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindBufferRange.xhtml">glBindBufferRange</a>
+     */
+    void bindBufferRange(GlBuffer::Target target, unsigned int index, unsigned int id, size_t offset, size_t size);
+
+    /// Returns true if the buffer with the given id is bound to target.
+    bool isBufferBound(GlBuffer::Target target, unsigned int id);
+
+    /**
+     * Binds the vertex array with the given id, unless it is already bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindVertexArray.xhtml">glBindVertexArray</a>
+     */
+    void bindVertexArray(unsigned int id);
+
+    /// Returns true if the vertex array with the given id is bound.
+    bool isVertexArrayBound(unsigned int id);
+
+    /**
+     * Uses the program with the given id, unless it is already used.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glUseProgram.xhtml">glUseProgram</a>
+     */
+    void useProgram(unsigned int id);
+
+    /// Returns true if the program with the given id is used.
+    bool isProgramUsed(unsigned int id);
+
+    /**
+     * Changes the active texture unit, unless it is already active.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glActiveTexture.xhtml">glActiveTexture</a>
+     */
+    void activeTexture(unsigned int unit);
+
+    /**
+     * Binds the texture with the given id to the active texture unit, unless it is already bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindTexture.xhtml">glBindTexture</a>
+     */
+    void bindTexture(GlTexture::Type type, unsigned int id);
+
+    /// Returns true if the texture with the given id is bound to the active texture unit.
+    bool isTextureBound(GlTexture::Type type, unsigned int id);
+
+    /**
+     * Binds the framebuffer with the given id to target, unless it is already bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindFramebuffer.xhtml">glBindFramebuffer</a>
+     */
+    void bindFrameBuffer(GlFrameBuffer::Target target, unsigned int id);
+
+    /// Returns true if the framebuffer with the given id is bound for drawing or reading.
+    bool isFrameBufferBound(unsigned int id);
+
+    /**
+     * Binds the renderbuffer with the given id, unless it is already bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindRenderbuffer.xhtml">glBindRenderbuffer</a>
+     */
+    void bindRenderBuffer(unsigned int id);
+
+    /// Returns true if the renderbuffer with the given id is bound.
+    bool isRenderBufferBound(unsigned int id);
+
+    /// Must be called when a buffer is deleted, since the GL implicitly unbinds it.
+    void bufferDeleted(unsigned int id);
+
+    /// Must be called when a vertex array is deleted, since the GL implicitly unbinds it.
+    void vertexArrayDeleted(unsigned int id);
+
+    /// Must be called when a texture is deleted, since the GL implicitly unbinds it.
+    void textureDeleted(unsigned int id);
+
+    /// Must be called when a framebuffer is deleted, since the GL implicitly unbinds it.
+    void frameBufferDeleted(unsigned int id);
+
+    /// Must be called when a renderbuffer is deleted, since the GL implicitly unbinds it.
+    void renderBufferDeleted(unsigned int id);
+
+private:
+    // binding slots, the texture slots of all units follow the fixed slots
+    enum Slot
+    {
+        ArrayBuffer,
+        ElementArrayBuffer,
+        DrawIndirectBuffer,
+        DispatchIndirectBuffer,
+        ShaderStorageBuffer,
+        UniformBuffer,
+        VertexArray,
+        Program,
+        DrawFrameBuffer,
+        ReadFrameBuffer,
+        RenderBuffer,
+        NumFixedSlots
+    };
+
+    static const unsigned int NumTextureTypes = 3;
+
+    // buffer range bound to an indexed binding point, size 0 is the whole buffer
+    struct IndexedBinding
+    {
+        unsigned int id;
+        size_t offset;
+        size_t size;
+    };
+
+    bool bind(size_t slot, unsigned int id);
+    bool isBound(size_t slot, unsigned int id);
+    unsigned int query(size_t slot) const;
+    unsigned int& cached(size_t slot);
+    size_t bufferSlot(GlBuffer::Target target) const;
+    size_t textureSlot(GlTexture::Type type);
+    void deleted(size_t first, size_t last, unsigned int id);
+    bool bindIndexed(GlBuffer::Target target, unsigned int index, unsigned int id, size_t offset, size_t size);
+
+private:
+    std::vector<unsigned int> _bindings;
+    std::vector<IndexedBinding> _storageBindings;
+    std::vector<IndexedBinding> _uniformBindings;
+    unsigned int _activeUnit;
+    bool _verify;
+    bool _directStateAccess;
+    Statistics _statistics;
+};
+
+#endif // GLSTATE_H
@@ -0,0 +1,176 @@
+#ifndef GLSTD140_H
+#define GLSTD140_H
+
+#include "glue/GlConfig.h"
+
+#ifdef GLUE_GLM
+#include <glm/glm.hpp>
+#endif
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * Types to declare C++ structs with the std140 layout of GLSL uniform blocks, so a block can be uploaded with one copy.
+ *
+ * All types except vec3 and ivec3 have the base alignment of std140 as their C++ alignment, so the compiler places
+ * them at the same offsets as the GL. A vec3 only occupies 12 bytes and the following scalar is packed into
+ * its last 4 bytes, therefore vec3 members must be declared alignas(16). \ref GLUE_STD140_CHECK fails to compile
+ * if a member is not aligned as std140 requires, e.g. if the alignas was forgotten.
+ *
+ * \code
+ * // layout(std140) uniform Camera { mat4 viewProjection; vec3 position; float time; vec2 viewport; };
+ * struct Camera
+ * {
+ *     GlStd140::mat4 viewProjection;
+ *     alignas(16) GlStd140::vec3 position;
+ *     float time;
+ *     GlStd140::vec2 viewport;
+ * };
+ * GLUE_STD140_CHECK(Camera, position);
+ * \endcode
+ */
+namespace GlStd140
+{
+    /// Two component float vector, base alignment 8
+    struct alignas(8) vec2
+    {
+        float x, y;
+
+        vec2(): x(0.0f), y(0.0f) {}
+        vec2(float x, float y): x(x), y(y) {}
+#ifdef GLUE_GLM
+        vec2(const glm::vec2& v): x(v.x), y(v.y) {}
+#endif
+    };
+
+    /// Three component float vector, base alignment 16 (must be declared alignas(16))
+    struct vec3
+    {
+        float x, y, z;
+
+        vec3(): x(0.0f), y(0.0f), z(0.0f) {}
+        vec3(float x, float y, float z): x(x), y(y), z(z) {}
+#ifdef GLUE_GLM
+        vec3(const glm::vec3& v): x(v.x), y(v.y), z(v.z) {}
+#endif
+    };
+
+    /// Four component float vector, base alignment 16
+    struct alignas(16) vec4
+    {
+        float x, y, z, w;
+
+        vec4(): x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+        vec4(float x, float y, float z, float w): x(x), y(y), z(z), w(w) {}
+#ifdef GLUE_GLM
+        vec4(const glm::vec4& v): x(v.x), y(v.y), z(v.z), w(v.w) {}
+#endif
+    };
+
+    /// Two component int vector, base alignment 8
+    struct alignas(8) ivec2
+    {
+        int x, y;
+
+        ivec2(): x(0), y(0) {}
+        ivec2(int x, int y): x(x), y(y) {}
+#ifdef GLUE_GLM
+        ivec2(const glm::ivec2& v): x(v.x), y(v.y) {}
+#endif
+    };
+
+    /// Three component int vector, base alignment 16 (must be declared alignas(16))
+    struct ivec3
+    {
+        int x, y, z;
+
+        ivec3(): x(0), y(0), z(0) {}
+        ivec3(int x, int y, int z): x(x), y(y), z(z) {}
+#ifdef GLUE_GLM
+        ivec3(const glm::ivec3& v): x(v.x), y(v.y), z(v.z) {}
+#endif
+    };
+
+    /// Four component int vector, base alignment 16
+    struct alignas(16) ivec4
+    {
+        int x, y, z, w;
+
+        ivec4(): x(0), y(0), z(0), w(0) {}
+        ivec4(int x, int y, int z, int w): x(x), y(y), z(z), w(w) {}
+#ifdef GLUE_GLM
+        ivec4(const glm::ivec4& v): x(v.x), y(v.y), z(v.z), w(v.w) {}
+#endif
+    };
+
+    /// Column major 3x3 float matrix, each column is padded to a vec4
+    struct alignas(16) mat3
+    {
+        vec4 columns[3];
+
+        mat3() {}
+#ifdef GLUE_GLM
+        mat3(const glm::mat3& m)
+        {
+            for(int i=0; i<3; ++i)
+                columns[i] = vec4(m[i].x, m[i].y, m[i].z, 0.0f);
+        }
+#endif
+    };
+
+    /// Column major 4x4 float matrix
+    struct alignas(16) mat4
+    {
+        vec4 columns[4];
+
+        mat4() {}
+#ifdef GLUE_GLM
+        mat4(const glm::mat4& m)
+        {
+            for(int i=0; i<4; ++i)
+                columns[i] = m[i];
+        }
+#endif
+    };
+
+    /// Array of N elements, each element starts at a multiple of 16 bytes
+    template<class T, size_t N>
+    struct alignas(16) array
+    {
+        struct alignas(16) element
+        {
+            T value;
+        };
+        element elements[N];
+
+        T& operator[](size_t i) { return elements[i].value; }
+        const T& operator[](size_t i) const { return elements[i].value; }
+        size_t size() const { return N; }
+    };
+
+    /// Base alignment of a type in std140, scalars are aligned to 4 bytes, doubles to 8 and nested structs to 16
+    template<class T>
+    struct base_alignment
+    {
+        static_assert(!std::is_same<T, bool>::value, "bool has 1 byte in C++ but 4 bytes in std140, use int instead");
+        static const size_t value = std::is_class<T>::value ? 16 : std::is_same<T, double>::value ? 8 : 4;
+    };
+
+    template<> struct base_alignment<vec2> { static const size_t value = 8; };
+    template<> struct base_alignment<ivec2> { static const size_t value = 8; };
+    template<> struct base_alignment<vec3> { static const size_t value = 16; };
+    template<> struct base_alignment<ivec3> { static const size_t value = 16; };
+    template<> struct base_alignment<vec4> { static const size_t value = 16; };
+    template<> struct base_alignment<ivec4> { static const size_t value = 16; };
+    template<> struct base_alignment<mat3> { static const size_t value = 16; };
+    template<> struct base_alignment<mat4> { static const size_t value = 16; };
+    template<class T, size_t N> struct base_alignment<array<T, N>> { static const size_t value = 16; };
+}
+
+/// Fails to compile if member of the struct is not placed at an offset std140 allows for its type
+#define GLUE_STD140_CHECK(Struct, member) \
+    static_assert(offsetof(Struct, member) % GlStd140::base_alignment<decltype(Struct::member)>::value == 0, \
+                  #Struct "::" #member " is not aligned as std140 requires")
+
+#endif // GLSTD140_H
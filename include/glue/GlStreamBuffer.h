@@ -0,0 +1,135 @@
+#ifndef GLSTREAMBUFFER_H
+#define GLSTREAMBUFFER_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlBuffer.h"
+
+#include <vector>
+
+/**
+ * The GlStreamBuffer class is a GlBuffer for data that is rewritten every frame.
+ * The storage is allocated once and split into a number of equally sized frame regions that are used as a ring.
+ * Each frame, data is written directly into the mapped memory of the current region, no temporary copies are made.
+ * A fence is inserted at the end of each frame so a region is only reused after the GPU finished reading it.
+ *
+ * If ARB_buffer_storage is available, the storage is immutable and persistently mapped.
+ * Otherwise only the unused part of the current region is mapped (unsynchronized) when needed
+ * and the storage is orphaned instead of stalling if the GPU still reads a region that is about to be reused.
+ * Immutable storage that could not be mapped persistently is never orphaned, the fences are waited for instead.
+ *
+ * \code
+ * GlStreamBuffer stream(GlBuffer::Target::Array);
+ * stream.bind();
+ * stream.allocateStorage(4*1024*1024);
+ * // every frame:
+ * stream.beginFrame();
+ * auto a = stream.allocate(vertices.size() * sizeof(glm::vec3));
+ * std::copy(vertices.begin(), vertices.end(), static_cast<glm::vec3*>(a.data));
+ * stream.commit();
+ * // .. draw using a.offset ..
+ * stream.endFrame();
+ * \endcode
+ */
+class GlStreamBuffer : public GlBuffer
+{
+public:
+    /// A block of memory inside the current frame region
+    struct Allocation
+    {
+        void* data;    ///< CPU pointer to the mapped memory, nullptr if the allocation failed
+        size_t offset; ///< byte offset of the block in the buffer (e.g. for glVertexAttribPointer)
+        size_t size;   ///< size of the block in bytes
+    };
+
+    /**
+     * Creates a new stream buffer without storage.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGenBuffers.xhtml">glGenBuffers</a>
+     */
+    GlStreamBuffer(Target target);
+
+    /**
+     * Deletes the fences and the buffer.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDeleteSync.xhtml">glDeleteSync</a>
+     */
+    virtual ~GlStreamBuffer();
+
+    /**
+     * Allocates numFrames regions of frameSize bytes each.
+     * Uses immutable, persistently mapped storage if supported and the usage hint StreamDraw otherwise.
+     * This should only be called once, since it discards all regions and fences.
+     * The buffer must be bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferStorage.xhtml">glBufferStorage</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glMapBufferRange.xhtml">glMapBufferRange</a>
+     */
+    void allocateStorage(size_t frameSize, unsigned int numFrames=3);
+
+    /**
+     * Advances to the next frame region.
+     * Blocks until the GPU finished reading the region if persistent mapping is used.
+     * Otherwise the storage is orphaned if the region is still in use.
+     * The buffer must be bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glClientWaitSync.xhtml">glClientWaitSync</a>
+     */
+    void beginFrame();
+
+    /**
+     * Returns a block of size bytes in the current frame region.
+     * The offset of the block is a multiple of alignment.
+     * If the region has not enough space left, the data pointer of the allocation is nullptr.
+     * The memory is only valid until \ref commit is called.
+     * The buffer must be bound.
+     */
+    Allocation allocate(size_t size, size_t alignment=16);
+
+    /**
+     * Makes all data written since the last commit available to the GPU.
+     * Must be called before drawing with data of the current frame.
+     * Does nothing if the storage is persistently mapped.
+     * The buffer must be bound.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glFlushMappedBufferRange.xhtml">glFlushMappedBufferRange</a>
+     */
+    void commit();
+
+    /**
+     * Commits pending data and inserts a fence for the current region.
+     * Must be called after all draw calls that use data of the current frame.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glFenceSync.xhtml">glFenceSync</a>
+     */
+    void endFrame();
+
+    /**
+     * Returns true if the storage is immutable and persistently mapped.
+     */
+    bool isPersistent() const;
+
+    /**
+     * Returns the size in bytes of a single frame region.
+     */
+    size_t frameSize() const;
+
+    /**
+     * Returns the number of frame regions.
+     */
+    unsigned int numFrames() const;
+
+    /**
+     * Returns the number of bytes already allocated in the current frame region.
+     */
+    size_t used() const;
+
+private:
+    void waitForFence(unsigned int frame);
+    void deleteFences();
+
+private:
+    size_t _frameSize;
+    unsigned int _frame;
+    size_t _cursor;
+    bool _persistent;
+    bool _immutable;
+    char* _mapping;
+    size_t _mappedOffset;
+    std::vector<void*> _fences;
+};
+
+#endif // GLSTREAMBUFFER_H
@@ -94,10 +94,12 @@ public:
     };
 
     /**
-     * Creates a new, empty texture.
+     * Creates a new, empty texture of the given type.
+     * The type is required to create the texture with direct state access, since type() cannot be called in the constructor.
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGenTextures.xhtml">glGenTextures</a>
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glCreateTextures.xhtml">glCreateTextures</a>
      */
-    GlTexture();
+    explicit GlTexture(Type type);
 
     /**
      * Deletes the texture.
@@ -163,6 +165,12 @@ public:
     void setMagFilter(MagFilter filter);
 
 protected:
+    /// Sets a texture parameter, by name if direct state access is available and on the bound texture otherwise.
+    void setParameter(unsigned int name, int value);
+
+    /// Binds the texture before glTexImage* if direct state access is used, since the image specification has no DSA variant.
+    void prepareImage();
+
     unsigned int _id;
     InternalFormat _format;
 };
@@ -0,0 +1,84 @@
+#ifndef GLUNIFORMRING_H
+#define GLUNIFORMRING_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlStreamBuffer.h"
+
+#include <type_traits>
+
+/**
+ * The GlUniformRing class allocates the values of uniform blocks from a per-frame ring of a \ref GlStreamBuffer.
+ * Each block is written once into the mapped memory at an offset that satisfies GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+ * and bound to a binding point with glBindBufferRange. Binding the same range again is skipped by \ref GlState.
+ *
+ * Blocks that are shared by many programs (e.g. camera constants) are pushed once per frame instead of being set
+ * as individual uniforms of every program. Block structs can be declared with \ref GlStd140.
+ *
+ * \code
+ * enum Bindings { CameraBinding, MaterialBinding };
+ * program.setUniformBlockBinding("Camera", CameraBinding);
+ * program.setUniformBlockBinding("Material", MaterialBinding);
+ *
+ * GlUniformRing ring;
+ * ring.bind();
+ * ring.allocateStorage(1024*1024);
+ * // every frame:
+ * ring.beginFrame();
+ * auto camera = ring.push(cameraBlock);
+ * std::vector<GlStreamBuffer::Allocation> materials;
+ * for(const auto& object: objects)
+ *     materials.push_back(ring.push(object.material));
+ * ring.commit();
+ * ring.bindRange(CameraBinding, camera);
+ * for(size_t i=0; i<objects.size(); ++i)
+ * {
+ *     ring.bindRange(MaterialBinding, materials[i]);
+ *     objects[i].draw();
+ * }
+ * ring.endFrame();
+ * \endcode
+ */
+class GlUniformRing : public GlStreamBuffer
+{
+public:
+    /**
+     * Creates a new uniform ring without storage, see \ref allocateStorage.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGenBuffers.xhtml">glGenBuffers</a>
+     */
+    GlUniformRing();
+
+    /**
+     * Returns the alignment of buffer ranges bound to uniform blocks.
+     * The value is queried once.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glGet.xhtml">GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT</a>
+     */
+    static size_t offsetAlignment();
+
+    /**
+     * Copies size bytes of data into the current frame region.
+     * The size of the allocation is rounded up to 16 bytes, since the GL rounds the size of std140 blocks as well.
+     * The data pointer of the allocation is nullptr if the region is full.
+     * \ref commit must be called before the data is used.
+     */
+    Allocation push(const void* data, size_t size);
+
+    /**
+     * Copies the block into the current frame region.
+     * \see push(const void* data, size_t size)
+     */
+    template<class T>
+    Allocation push(const T& block)
+    {
+        static_assert(std::is_standard_layout<T>::value, "uniform blocks must be plain data");
+        return push(&block, sizeof(T));
+    }
+
+    /**
+     * Binds the allocation to a uniform block binding point (see \ref GlProgram::setUniformBlockBinding).
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindBufferRange.xhtml">glBindBufferRange</a>
+     */
+    void bindRange(unsigned int index, const Allocation& allocation);
+    using GlBuffer::bindRange;
+};
+
+#endif // GLUNIFORMRING_H
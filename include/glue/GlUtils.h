@@ -1,6 +1,12 @@
 #ifndef GLUTILS_H
 #define GLUTILS_H
 
+#include "glue/GlBuffer.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
 class GlProgram;
 
 namespace GlUtils
@@ -31,6 +37,189 @@ namespace GlUtils
     private:
         T& _object;
     };
+
+    /**
+     * \brief The array_view class is a non-owning view of a contiguous array of T.
+     * It allows passing vectors or raw pointer + count pairs to upload functions without copying the data.
+     * The viewed memory must stay valid as long as the view is used.
+     */
+    template<class T>
+    class array_view
+    {
+    public:
+        array_view():
+            _data(nullptr),
+            _size(0)
+        {
+
+        }
+
+        array_view(const T* data, size_t size):
+            _data(data),
+            _size(size)
+        {
+
+        }
+
+        array_view(const std::vector<T>& v):
+            _data(v.data()),
+            _size(v.size())
+        {
+
+        }
+
+        const T* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        const T* begin() const { return _data; }
+        const T* end() const { return _data + _size; }
+        const T& operator[](size_t i) const { return _data[i]; }
+
+    private:
+        const T* _data;
+        size_t _size;
+    };
+
+    /// Creates an array_view of count elements starting at data
+    template<class T>
+    array_view<T> make_view(const T* data, size_t count)
+    {
+        return array_view<T>(data, count);
+    }
+
+    /// Creates an array_view of all elements of the vector
+    template<class T>
+    array_view<T> make_view(const std::vector<T>& v)
+    {
+        return array_view<T>(v);
+    }
+
+    /**
+     * Returns the 32 bit FNV-1a hash of a null-terminated string.
+     * The function is constexpr, so the hashes of string literals can be computed at compile time.
+     */
+    constexpr uint32_t hash_string(const char* str, uint32_t hash=2166136261u)
+    {
+        return *str ? hash_string(str + 1, (hash ^ static_cast<uint8_t>(*str)) * 16777619u) : hash;
+    }
+
+    /// Returns the 32 bit FNV-1a hash of the string, equal to the hash of its characters
+    inline uint32_t hash_string(const std::string& str)
+    {
+        uint32_t hash = 2166136261u;
+        for(char c: str)
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        return hash;
+    }
+
+    /// Returns the 64 bit FNV-1a hash of size bytes, hash allows to combine the hashes of several blocks
+    inline uint64_t hash_bytes(const void* data, size_t size, uint64_t hash=14695981039346656037ull)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for(size_t i=0; i<size; ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        return hash;
+    }
+
+    /**
+     * Returns the 64 bit FNV-1a hash of the length and the characters of the string.
+     * The length is hashed as well, so moving characters between combined strings changes the hash.
+     */
+    inline uint64_t hash_bytes(const std::string& str, uint64_t hash=14695981039346656037ull)
+    {
+        const uint64_t size = str.size();
+        hash = hash_bytes(&size, sizeof(size), hash);
+        return hash_bytes(str.data(), str.size(), hash);
+    }
+
+    /**
+     * Reads the whole file into contents through a \ref mapped_file.
+     * Returns false if the file could not be opened.
+     */
+    bool read_file(const std::string& path, std::string& contents);
+
+    /**
+     * \brief The mapped_file class maps a file read-only into memory for the lifetime of the object.
+     * Reading a file this way avoids copying it through stream buffers.
+     * An empty or missing file results in an invalid mapping.
+     */
+    class mapped_file
+    {
+    public:
+        explicit mapped_file(const std::string& path);
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) =delete;
+        mapped_file& operator=(const mapped_file&) =delete;
+
+        /// Returns false if the file could not be mapped
+        explicit operator bool() const { return _data != nullptr; }
+
+        const char* data() const { return _data; }
+        size_t size() const { return _size; }
+        const char* begin() const { return _data; }
+        const char* end() const { return _data + _size; }
+
+    private:
+        const char* _data;
+        size_t _size;
+#ifdef _WIN32
+        void* _file;
+        void* _mapping;
+#endif
+    };
+
+    /**
+     * \brief The map_guard class maps a range of a GlBuffer as an array of T for the lifetime of the guard.
+     * The range starts at the byte offset and contains count elements of type T.
+     * The buffer is unmapped if the map_guard object goes out of scope.
+     * The buffer must be bound while the map_guard exists.
+     *
+     * \code
+     * vbo.bind();
+     * {
+     *     GlUtils::map_guard<glm::vec3> positions(vbo, 0, numVertices, GlBuffer::MapWrite | GlBuffer::MapInvalidateRange);
+     *     for(size_t i=0; i<positions.size(); ++i)
+     *         positions[i] = ...;
+     * }
+     * \endcode
+     * \see GlBuffer::map
+     */
+    template<class T>
+    class map_guard
+    {
+    public:
+        map_guard(GlBuffer& buffer, size_t offset, size_t count, unsigned int access):
+            _buffer(buffer),
+            _data(static_cast<T*>(buffer.map(offset, count * sizeof(T), access))),
+            _size(_data ? count : 0)
+        {
+
+        }
+
+        ~map_guard()
+        {
+            if(_data)
+                _buffer.unmap();
+        }
+
+        map_guard(const map_guard&) =delete;
+        map_guard& operator=(const map_guard&) =delete;
+
+        /// Returns false if the mapping failed
+        explicit operator bool() const { return _data != nullptr; }
+
+        T* data() const { return _data; }
+        size_t size() const { return _size; }
+        T* begin() const { return _data; }
+        T* end() const { return _data + _size; }
+        T& operator[](size_t i) const { return _data[i]; }
+
+    private:
+        GlBuffer& _buffer;
+        T* _data;
+        size_t _size;
+    };
 };
 
 #endif // GLUTILS_H
@@ -4,6 +4,10 @@
 #include "glue/GlConfig.h"
 #include "glue/GlVertexBuffer.h"
 #include "glue/GlIndexBuffer.h"
+#include "glue/GlIndirectBuffer.h"
+#include "glue/GlUtils.h"
+
+#include <vector>
 
 /**
  * The GlVertexArray class stores all states required to draw vertex data.
@@ -82,6 +86,70 @@ public:
      */
     virtual void setVertexData(GlVertexBuffer &vbo);
 
+    /**
+     * Attaches a GlVertexBuffer as one of multiple vertex streams, e.g. static positions and normals in stream 0
+     * and per-frame colors in stream 1, so only the dynamic stream has to be updated every frame.
+     * The attributes of the buffer get the indices firstIndex, firstIndex+1, .. and advance once per divisor instances (0 advances per vertex).
+     * Setting a stream replaces the buffer previously attached as the same stream, \ref setVertexData attaches stream 0 with firstIndex 0.
+     * The number of vertices drawn by \ref draw is the smallest number of vertices of all per-vertex streams.
+     * The stream must be set again if the attribute layout of the buffer changes (e.g. non-interleaved data with a different number of vertices).
+     * Otherwise the same rules as for \ref setVertexData apply.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glVertexAttribPointer.xhtml">glVertexAttribPointer</a>
+     */
+    virtual void setVertexStream(unsigned int stream, GlVertexBuffer& vbo, unsigned int firstIndex, unsigned int divisor=0);
+
+    /**
+     * Sets the vertex data of the vertex array from a plain buffer, e.g. a block of a \ref GlBufferArena.
+     * The attributes describe the layout of the vertices in the buffer (see \ref GlVertexLayout::attributes).
+     * Since the number of vertices is unknown, only draw calls with an explicit count can be used.
+     * Otherwise the same rules as for \ref setVertexData(GlVertexBuffer&) apply.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glVertexAttribPointer.xhtml">glVertexAttribPointer</a>
+     */
+    virtual void setVertexData(GlBuffer& vbo, const std::vector<GlVertexBuffer::VertexAttribute>& attributes);
+
+    /**
+     * Sets a second vertex buffer as per-instance stream, e.g. for transformations of instances.
+     * The attributes of the buffer get the indices firstIndex, firstIndex+1, .. (i.e. firstIndex is usually the number of attributes of the vertex data)
+     * and advance once per divisor instances instead of once per vertex.
+     * The VBO gets automatically bound and must remain valid as long as the VAO is valid.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glVertexAttribDivisor.xhtml">glVertexAttribDivisor</a>
+     */
+    virtual void setInstanceData(GlVertexBuffer& vbo, unsigned int firstIndex, unsigned int divisor=1);
+
+    /**
+     * Sets the number of instances that share a value of the attribute with the given index.
+     * A divisor of 0 (the default) advances the attribute per vertex.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glVertexAttribDivisor.xhtml">glVertexAttribDivisor</a>
+     */
+    void setAttributeDivisor(unsigned int index, unsigned int divisor);
+
+    /**
+     * Declares the interleaved vertex format of a binding point once, independent of any buffer.
+     * The pointer of each attribute is its offset inside a vertex (e.g. \ref GlVertexLayout::attributes), the stride is set by \ref bindVertexBuffer.
+     * Afterwards switching between meshes with this format only requires \ref bindVertexBuffer,
+     * so one vertex array per vertex format can draw all meshes of that format.
+     * Uses ARB_vertex_attrib_binding if available. Otherwise the format is stored and the attribute pointers are set by \ref bindVertexBuffer.
+     * If autoEnableAttributes was set to true, all attributes are enabled.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glVertexAttribFormat.xhtml">glVertexAttribFormat</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glVertexAttribBinding.xhtml">glVertexAttribBinding</a>
+     */
+    virtual void setVertexFormat(const std::vector<GlVertexBuffer::VertexAttribute>& attributes, unsigned int binding=0);
+
+    /**
+     * Uses the vertices in buffer starting at offset bytes with stride bytes between two vertices for the format of the binding point
+     * (see \ref setVertexFormat), e.g. a mesh in a block of a \ref GlBufferArena.
+     * The stride must be greater than 0, it is not derived from the format (e.g. use \ref GlVertexLayout::stride).
+     * The buffer must remain valid as long as it is used by the VAO.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBindVertexBuffer.xhtml">glBindVertexBuffer</a>
+     */
+    virtual void bindVertexBuffer(unsigned int binding, GlBuffer& buffer, size_t offset, size_t stride);
+
+    /**
+     * Sets the number of instances that share a value of the attributes of the binding point (0 advances per vertex).
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glVertexBindingDivisor.xhtml">glVertexBindingDivisor</a>
+     */
+    void setBindingDivisor(unsigned int binding, unsigned int divisor);
+
     /**
      * Sets an optional index buffer.
      * The IBO gets automatically bound and must remain bound until the VAO is released.
@@ -90,6 +158,12 @@ public:
      */
     virtual void setIndexBuffer(GlIndexBuffer &ibo);
 
+    /**
+     * Sets an index buffer from a plain buffer containing indices of the given type, e.g. a block of a \ref GlBufferArena.
+     * Since the number of indices is unknown, only draw calls with an explicit count can be used.
+     */
+    virtual void setIndexBuffer(GlBuffer& ibo, GlIndexBuffer::IndexType type);
+
     /**
      * Draws the primitves of the vertex buffer directly without an index buffer.
      * The mode usually depends on the content of the vertex buffer, e.g. rendering Lines as Triangles will probably result in artifacts.
@@ -97,6 +171,13 @@ public:
      */
 	virtual void draw(Primitive mode);
 
+    /**
+     * Draws count vertices starting at vertex first without an index buffer,
+     * e.g. a single mesh of a vertex buffer that contains multiple meshes.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDrawArrays.xhtml">glDrawArrays</a>
+     */
+    virtual void draw(Primitive mode, size_t first, size_t count);
+
     /**
      * Draws primitives by retrieving vertex data according to the index buffer.
      * An index buffer must be set in advance otherwise nothing is drawn.
@@ -104,6 +185,78 @@ public:
      */
     virtual void drawElements(Primitive mode);
 
+    /**
+     * Draws count indices starting at firstIndex from the index buffer.
+     * The baseVertex is added to each index before fetching the vertex,
+     * so meshes packed into the same buffers can be drawn with their original (zero based) indices.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDrawElementsBaseVertex.xhtml">glDrawElementsBaseVertex</a>
+     */
+    virtual void drawElements(Primitive mode, size_t count, size_t firstIndex, int baseVertex=0);
+
+    /**
+     * Same as \ref drawElements(Primitive, size_t, size_t, int), but additionally promises that all indices
+     * of the range are between minIndex and maxIndex (before adding baseVertex, see \ref GlIndexBuffer::minIndex).
+     * This allows the driver to only prepare the referenced vertices.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDrawRangeElementsBaseVertex.xhtml">glDrawRangeElementsBaseVertex</a>
+     */
+    virtual void drawRangeElements(Primitive mode, unsigned int minIndex, unsigned int maxIndex, size_t count, size_t firstIndex, int baseVertex=0);
+
+    /**
+     * Draws instanceCount instances of the primitves of the vertex buffer without an index buffer.
+     * Instanced attributes start at element baseInstance (this does not affect gl_InstanceID).
+     * Without ARB_base_instance the offset is emulated for the attributes of the \ref setInstanceData "instance stream" by moving their pointers.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDrawArraysInstanced.xhtml">glDrawArraysInstanced</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glDrawArraysInstancedBaseInstance.xhtml">glDrawArraysInstancedBaseInstance</a>
+     */
+    virtual void drawInstanced(Primitive mode, size_t instanceCount, unsigned int baseInstance=0);
+
+    /**
+     * Draws instanceCount instances of the primitives of the index buffer.
+     * The baseInstance is handled like in \ref drawInstanced.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glDrawElementsInstanced.xhtml">glDrawElementsInstanced</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glDrawElementsInstancedBaseInstance.xhtml">glDrawElementsInstancedBaseInstance</a>
+     */
+    virtual void drawElementsInstanced(Primitive mode, size_t instanceCount, unsigned int baseInstance=0);
+
+    /**
+     * Draws multiple ranges of the vertex buffer with a single call, range i starts at vertex first[i] and has counts[i] vertices.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMultiDrawArrays.xhtml">glMultiDrawArrays</a>
+     */
+    virtual void multiDraw(Primitive mode, GlUtils::array_view<int> first, GlUtils::array_view<int> counts);
+
+    /**
+     * Draws multiple ranges of the index buffer with a single call, range i starts at index firstIndices[i] and has counts[i] indices.
+     * If baseVertices is not empty, baseVertices[i] is added to the indices of range i (see \ref drawElements(Primitive, size_t, size_t, int)).
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMultiDrawElements.xhtml">glMultiDrawElements</a>,
+     * <a href="https://www.opengl.org/sdk/docs/man/html/glMultiDrawElementsBaseVertex.xhtml">glMultiDrawElementsBaseVertex</a>
+     */
+    virtual void multiDrawElements(Primitive mode, GlUtils::array_view<int> counts, GlUtils::array_view<unsigned int> firstIndices,
+                                   GlUtils::array_view<int> baseVertices=GlUtils::array_view<int>());
+
+    /**
+     * Executes all \ref GlIndirectBuffer::DrawArraysCommand "commands" of the indirect buffer with a single call.
+     * The indirect buffer gets bound.
+     * Falls back to one glDrawArraysIndirect per command without ARB_multi_draw_indirect
+     * and to reading back the commands without ARB_draw_indirect.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMultiDrawArraysIndirect.xhtml">glMultiDrawArraysIndirect</a>
+     */
+    virtual void multiDrawIndirect(Primitive mode, GlIndirectBuffer& indirect);
+
+    /// Executes numCommands commands of the indirect buffer starting at firstCommand, see \ref multiDrawIndirect(Primitive, GlIndirectBuffer&)
+    virtual void multiDrawIndirect(Primitive mode, GlIndirectBuffer& indirect, size_t firstCommand, size_t numCommands);
+
+    /**
+     * Executes all \ref GlIndirectBuffer::DrawElementsCommand "commands" of the indirect buffer with a single call.
+     * The indirect buffer gets bound.
+     * Falls back to one glDrawElementsIndirect per command without ARB_multi_draw_indirect
+     * and to reading back the commands without ARB_draw_indirect.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMultiDrawElementsIndirect.xhtml">glMultiDrawElementsIndirect</a>
+     */
+    virtual void multiDrawElementsIndirect(Primitive mode, GlIndirectBuffer& indirect);
+
+    /// Executes numCommands commands of the indirect buffer starting at firstCommand, see \ref multiDrawElementsIndirect(Primitive, GlIndirectBuffer&)
+    virtual void multiDrawElementsIndirect(Primitive mode, GlIndirectBuffer& indirect, size_t firstCommand, size_t numCommands);
+
     /**
      * Enables the attribute with the given index.
      * The index of each attribute is determined by the order in the GlVertexBuffer.
@@ -118,12 +271,31 @@ public:
      */
 	void disableAttribute(unsigned int index);
 
+private:
+    struct VertexStream
+    {
+        GlVertexBuffer* buffer;
+        unsigned int firstIndex;
+        unsigned int numAttributes;
+        unsigned int divisor;
+    };
+
+    void setAttribute(const GlVertexBuffer::VertexAttribute& attribute, size_t offset=0);
+    void setInstanceOffset(unsigned int baseInstance);
+    void submitArrays(Primitive mode, size_t first, size_t count, size_t instanceCount, unsigned int baseInstance);
+    void submitElements(Primitive mode, size_t count, size_t firstIndex, int baseVertex, size_t instanceCount, unsigned int baseInstance);
+
 private:
     unsigned int _id;
     bool _autoEnableAttributes;
 	size_t _numVertices;
     size_t _numIndices;
     GlIndexBuffer::IndexType _indexType;
+    std::vector<VertexStream> _streams;
+    GlVertexBuffer* _instanceBuffer;
+    std::vector<GlVertexBuffer::VertexAttribute> _instanceAttributes;
+    // vertex formats of the binding points, only used without ARB_vertex_attrib_binding
+    std::vector<std::vector<GlVertexBuffer::VertexAttribute>> _bindingFormats;
 };
 
 #endif // GLVERTEXARRAY_H
@@ -3,12 +3,25 @@
 
 #include "glue/GlConfig.h"
 #include "glue/GlBuffer.h"
+#include "glue/GlUtils.h"
+
+#ifdef GLUE_GLM
+#include <glm/glm.hpp>
+#endif
+
+#ifdef GLUE_QT
+#include <QtGui/QVector2D>
+#include <QtGui/QVector3D>
+#include <QtGui/QVector4D>
+#endif
 
 #include <vector>
+#include <cassert>
+#include <type_traits>
 
 /**
  * The GlVertexBuffer class represents a list of vertices with one or more attributes.
- * Currently only supports non-interleaved buffers.
+ * The attributes are either stored one after the other (\ref setData) or interleaved per vertex (\ref setInterleavedData).
  * A GlVertexBuffer objects is best used with a \ref GlVertexArray that will automatically set the vertex attribute pointers.
  */
 class GlVertexBuffer : public GlBuffer
@@ -25,16 +38,21 @@ public:
             UnsignedShort,
             Int,
             UnsignedInt,
-            Float
+            HalfFloat,
+            Float,
+            Int2101010Rev,        ///< four signed components packed into 32 bit (size must be 4)
+            UnsignedInt2101010Rev ///< four unsigned components packed into 32 bit (size must be 4)
         };
 
-        VertexAttribute(unsigned int index, int size, Type type, bool normalized=false);
+        VertexAttribute(unsigned int index, int size, Type type, bool normalized=false, bool integer=false);
         unsigned int index;   ///< index of the attribute in the buffer
         int size;     ///< number of compenents (e.g. 2 for vec2)
-        size_t stride; ///< number of bytes between two attribute values (only required for interleaved buffers)
+        size_t stride; ///< number of bytes between two attribute values (0 for tightly packed, non-interleaved attributes)
         size_t pointer; ///< number of bytes to the first attribute value
         Type type;    ///< value type of the attribute (e.g. float)
         bool normalized;   ///< Signals if the value should be accessed normalized
+        bool integer;      ///< Signals if the value is passed as integer (e.g. to "in int") instead of being converted to float
+        unsigned int divisor; ///< number of instances that share a value (0 advances per vertex, 1 per instance)
 	};
 
     /**
@@ -49,10 +67,68 @@ public:
      * If multiple attributes are passed, all must have the same number of elements.
      * The argument index determines the attribute index (e.g. a0 is index 0, the next attribute is index 1)
      * This will override any previously set data.
+     * The vectors are not copied, their data is directly uploaded to the buffer.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferData.xhtml">glBufferData</a>
+     */
+    template<typename T, typename... U>
+    void setData(Usage usage, const std::vector<T>& a0, const std::vector<U>&... a);
+
+    /**
+     * Copies the vertices with one or multiple attributes from the given views to the buffer.
+     * Same as the vector version, but allows uploading arbitrary arrays (e.g. pointer + count, see \ref GlUtils::make_view).
      * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferData.xhtml">glBufferData</a>
      */
     template<typename T, typename... U>
-    void setData(Usage usage, std::vector<T> a0, std::vector<U>... a);
+    void setData(Usage usage, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a);
+
+    /**
+     * Copies the vertices with one or multiple attributes interleaved to the buffer.
+     * In contrast to \ref setData, all attributes of a vertex are stored next to each other,
+     * i.e. the buffer contains a0[0], a1[0], .., a0[1], a1[1], ...
+     * Attribute offsets are aligned to 4 bytes.
+     * The data is written directly into the mapped buffer.
+     * This will override any previously set data.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glMapBufferRange.xhtml">glMapBufferRange</a>
+     */
+    template<typename T, typename... U>
+    void setInterleavedData(Usage usage, const std::vector<T>& a0, const std::vector<U>&... a);
+
+    /// \copydoc setInterleavedData(Usage, const std::vector<T>&, const std::vector<U>&...)
+    template<typename T, typename... U>
+    void setInterleavedData(Usage usage, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a);
+
+    /**
+     * Copies an array of already interleaved vertices (e.g. a user defined vertex struct) to the buffer.
+     * The layout describes the attributes of a single vertex: the pointer of each attribute is its offset in the struct.
+     * Attributes with a stride of 0 get the size of V as stride.
+     * This will override any previously set data.
+     * \see <a href="https://www.opengl.org/sdk/docs/man/html/glBufferData.xhtml">glBufferData</a>
+     */
+    template<typename V>
+    void setInterleavedData(Usage usage, const std::vector<V>& vertices, const std::vector<VertexAttribute>& layout);
+
+    /// \copydoc setInterleavedData(Usage, const std::vector<V>&, const std::vector<VertexAttribute>&)
+    template<typename V>
+    void setInterleavedData(Usage usage, GlUtils::array_view<V> vertices, const std::vector<VertexAttribute>& layout);
+
+    /**
+     * Copies an array of vertex structs described by a compile-time \ref GlVertexLayout to the buffer.
+     * Fails to compile if the size of V does not match the stride of the layout.
+     * The order of the members can only be verified with \ref GLUE_VERTEX_LAYOUT_CHECK for each member.
+     * This will override any previously set data.
+     */
+    template<typename Layout, typename V>
+    void setInterleavedData(Usage usage, const std::vector<V>& vertices);
+
+    /// \copydoc setInterleavedData(Usage, const std::vector<V>&)
+    template<typename Layout, typename V>
+    void setInterleavedData(Usage usage, GlUtils::array_view<V> vertices);
+
+    /**
+     * Copies numVertices interleaved vertices with the given stride to the buffer.
+     * \see setInterleavedData(Usage, const std::vector<V>&, const std::vector<VertexAttribute>&)
+     */
+    void setInterleavedData(Usage usage, const void* vertices, size_t numVertices, size_t stride, const std::vector<VertexAttribute>& layout);
 
     /**
      * Returns the current number of vertices in the buffer.
@@ -70,33 +146,114 @@ public:
 	VertexAttribute attribute(unsigned int index) const;
 
 protected:
-    /// Computes the size in bytes of the vector
+    /// Computes the size in bytes of the array
 	template<typename T>
-	size_t getBufferSize(std::vector<T> a0);
+	size_t getBufferSize(GlUtils::array_view<T> a0);
 
-    /// Computes the size in bytes of all vectors combined
+    /// Computes the size in bytes of all arrays combined
     template<typename T, typename... U>
-    size_t getBufferSize(std::vector<T> a0, std::vector<U>... a);
+    size_t getBufferSize(GlUtils::array_view<T> a0, GlUtils::array_view<U>... a);
 
-    /// Copies the vector to the buffer starting from the offset
+    /// Copies the array to the buffer starting from the offset
 	template<typename T>
-	void setSubData(size_t offset, std::vector<T> a0);
+	void setSubData(size_t offset, GlUtils::array_view<T> a0);
+
+    /// Copies all arrays to the buffer starting from the offset.
+    template<typename T, typename... U>
+    void setSubData(size_t offset, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a);
+
+    /// Source array of an attribute that is interleaved into the buffer
+    struct InterleavedSource
+    {
+        const char* data; ///< first value of the attribute
+        size_t size;      ///< size of a single value in bytes
+        size_t offset;    ///< offset of the attribute inside a vertex
+    };
 
-    /// Copies all vectors to the buffer starting from the offset.
+    /// Adds the attribute at the given offset and returns the offset of the next attribute
+    template<typename T>
+    size_t addInterleavedAttribute(std::vector<InterleavedSource>& sources, size_t offset, GlUtils::array_view<T> a0);
+
+    /// Adds all attributes starting from the given offset and returns the size of a vertex
     template<typename T, typename... U>
-    void setSubData(size_t offset, std::vector<T> a0, std::vector<U>... a);
+    size_t addInterleavedAttribute(std::vector<InterleavedSource>& sources, size_t offset, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a);
+
+    /// Interleaves all sources directly into the mapped buffer
+    void writeInterleaved(const std::vector<InterleavedSource>& sources, size_t stride);
 
-    /// Creates a VertexAttribute for the template type and index.
+    /// Creates a VertexAttribute for the template type and index, see \ref GlVertexFormat.
 	template<typename T>
-    VertexAttribute createAttribute(unsigned int index);
+    static VertexAttribute createAttribute(unsigned int index);
 
 private:
 	std::vector<VertexAttribute> _attributes;
 	size_t _numVertices;
 };
 
+/**
+ * The GlVertexFormat struct describes how values of type T are passed to a vertex attribute.
+ * It is resolved at compile time, using an unsupported type as vertex attribute is a compile error.
+ * Support for further types can be added by specializing GlVertexFormat (e.g. by deriving from \ref GlVertexFormatBase).
+ * Each specialization provides:
+ *  - components: number of components (e.g. 2 for vec2)
+ *  - type: value type of a single component
+ *  - normalized: true if integer values are normalized to [0,1] or [-1,1]
+ *  - integer: true if the values are passed as integers (e.g. to "in int") instead of being converted to float
+ */
+template<typename T>
+struct GlVertexFormat
+{
+    static_assert(sizeof(T) == 0, "Type is not supported as vertex attribute, specialize GlVertexFormat");
+};
+
+/// Helper to define \ref GlVertexFormat specializations
+template<int Components, GlVertexBuffer::VertexAttribute::Type Type, bool Normalized=false, bool Integer=false>
+struct GlVertexFormatBase
+{
+    static constexpr int components = Components;
+    static constexpr GlVertexBuffer::VertexAttribute::Type type = Type;
+    static constexpr bool normalized = Normalized;
+    static constexpr bool integer = Integer;
+};
+
+template<> struct GlVertexFormat<float>: GlVertexFormatBase<1, GlVertexBuffer::VertexAttribute::Float> {};
+template<> struct GlVertexFormat<int>: GlVertexFormatBase<1, GlVertexBuffer::VertexAttribute::Int, false, true> {};
+template<> struct GlVertexFormat<unsigned int>: GlVertexFormatBase<1, GlVertexBuffer::VertexAttribute::UnsignedInt, false, true> {};
+
+#ifdef GLUE_GLM
+static_assert(sizeof(glm::vec2) == sizeof(float) * 2, "glm vector type not aligned correctly");
+static_assert(sizeof(glm::vec3) == sizeof(float) * 3, "glm vector type not aligned correctly");
+static_assert(sizeof(glm::vec4) == sizeof(float) * 4, "glm vector type not aligned correctly");
+
+template<> struct GlVertexFormat<glm::vec2>: GlVertexFormatBase<2, GlVertexBuffer::VertexAttribute::Float> {};
+template<> struct GlVertexFormat<glm::vec3>: GlVertexFormatBase<3, GlVertexBuffer::VertexAttribute::Float> {};
+template<> struct GlVertexFormat<glm::vec4>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::Float> {};
+#endif
+
+#ifdef GLUE_QT
+static_assert(sizeof(QVector2D) == sizeof(float) * 2, "QVector2D not aligned correctly");
+static_assert(sizeof(QVector3D) == sizeof(float) * 3, "QVector3D not aligned correctly");
+static_assert(sizeof(QVector4D) == sizeof(float) * 4, "QVector4D not aligned correctly");
+
+template<> struct GlVertexFormat<QVector2D>: GlVertexFormatBase<2, GlVertexBuffer::VertexAttribute::Float> {};
+template<> struct GlVertexFormat<QVector3D>: GlVertexFormatBase<3, GlVertexBuffer::VertexAttribute::Float> {};
+template<> struct GlVertexFormat<QVector4D>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::Float> {};
+#endif
+
+template<typename T>
+GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute(unsigned int index)
+{
+    return VertexAttribute(index, GlVertexFormat<T>::components, GlVertexFormat<T>::type, GlVertexFormat<T>::normalized, GlVertexFormat<T>::integer);
+}
+
+template<typename T, typename... U>
+void GlVertexBuffer::setData(Usage usage, const std::vector<T>& a0, const std::vector<U>&... a)
+{
+    setData(usage, GlUtils::array_view<T>(a0), GlUtils::array_view<U>(a)...);
+}
+
 template<typename T, typename... U>
-void GlVertexBuffer::setData(Usage usage, std::vector<T> a0, std::vector<U>... a)
+void GlVertexBuffer::setData(Usage usage, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a)
 {
     // clear previous data
 	_attributes.clear();
@@ -113,21 +270,23 @@ void GlVertexBuffer::setData(Usage usage, std::vector<T> a0, std::vector<U>... a
 }
 
 template<typename T>
-size_t GlVertexBuffer::getBufferSize(std::vector<T> a0)
+size_t GlVertexBuffer::getBufferSize(GlUtils::array_view<T> a0)
 {
 	return a0.size() * sizeof(T);
 }
 
 template<typename T, typename... U>
-size_t GlVertexBuffer::getBufferSize(std::vector<T> a0, std::vector<U>... a)
+size_t GlVertexBuffer::getBufferSize(GlUtils::array_view<T> a0, GlUtils::array_view<U>... a)
 {
-    // Take the first vector, compute the byte size and recursively add the size of the remaining vectors
+    // Take the first array, compute the byte size and recursively add the size of the remaining arrays
 	return a0.size() * sizeof(T) + getBufferSize(a...);
 }
 
 template<typename T>
-void GlVertexBuffer::setSubData(size_t offset, std::vector<T> a0)
+void GlVertexBuffer::setSubData(size_t offset, GlUtils::array_view<T> a0)
 {
+    assert(a0.size() == _numVertices);
+
     // Saves the properties of the current attribute
 	VertexAttribute attribute = createAttribute<T>(_attributes.size());
 	attribute.stride = 0;
@@ -135,24 +294,97 @@ void GlVertexBuffer::setSubData(size_t offset, std::vector<T> a0)
 	_attributes.push_back(attribute);
 
     // Copy the data to the buffer
-	GlBuffer::setSubData(&a0[0], getBufferSize(a0), offset);
+    if(!a0.empty())
+        GlBuffer::setSubData(a0.data(), getBufferSize(a0), offset);
 }
 
 template<typename T, typename... U>
-void GlVertexBuffer::setSubData(size_t offset, std::vector<T> a0, std::vector<U>... a)
+void GlVertexBuffer::setSubData(size_t offset, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a)
 {
-    // Saves the properties of the current attribute
-	VertexAttribute attribute = createAttribute<T>(_attributes.size());
-	attribute.stride = 0;
-	attribute.pointer = offset;
-	_attributes.push_back(attribute);
-
-    ///Copy the data to the buffer
-	GlBuffer::setSubData(&a0[0], getBufferSize(a0), offset);
+    // Copy the current attribute
+    setSubData(offset, a0);
     // Sets the offset point to after the current buffer
 	offset += getBufferSize(a0);
-    // Recursively copy the data for the remainging vectors
+    // Recursively copy the data for the remainging arrays
 	setSubData(offset, a...);
 }
 
+template<typename T, typename... U>
+void GlVertexBuffer::setInterleavedData(Usage usage, const std::vector<T>& a0, const std::vector<U>&... a)
+{
+    setInterleavedData(usage, GlUtils::array_view<T>(a0), GlUtils::array_view<U>(a)...);
+}
+
+template<typename T, typename... U>
+void GlVertexBuffer::setInterleavedData(Usage usage, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a)
+{
+    // clear previous data
+    _attributes.clear();
+
+    _numVertices = a0.size();
+
+    // Determine the layout of a single vertex
+    std::vector<InterleavedSource> sources;
+    size_t stride = addInterleavedAttribute(sources, 0, a0, a...);
+    for(auto& attribute: _attributes)
+        attribute.stride = stride;
+
+    // Allocate the memory and interleave the attributes into it
+    GlBuffer::setData(usage, nullptr, stride * _numVertices);
+    writeInterleaved(sources, stride);
+}
+
+template<typename V>
+void GlVertexBuffer::setInterleavedData(Usage usage, const std::vector<V>& vertices, const std::vector<VertexAttribute>& layout)
+{
+    setInterleavedData(usage, vertices.data(), vertices.size(), sizeof(V), layout);
+}
+
+template<typename V>
+void GlVertexBuffer::setInterleavedData(Usage usage, GlUtils::array_view<V> vertices, const std::vector<VertexAttribute>& layout)
+{
+    setInterleavedData(usage, vertices.data(), vertices.size(), sizeof(V), layout);
+}
+
+template<typename Layout, typename V>
+void GlVertexBuffer::setInterleavedData(Usage usage, const std::vector<V>& vertices)
+{
+    setInterleavedData<Layout>(usage, GlUtils::array_view<V>(vertices));
+}
+
+template<typename Layout, typename V>
+void GlVertexBuffer::setInterleavedData(Usage usage, GlUtils::array_view<V> vertices)
+{
+    static_assert(sizeof(V) == Layout::stride, "Size of the vertex type does not match the vertex layout");
+    static_assert(std::is_standard_layout<V>::value, "Vertex type must be a standard layout type");
+    setInterleavedData(usage, vertices.data(), vertices.size(), sizeof(V), Layout::attributes());
+}
+
+template<typename T>
+size_t GlVertexBuffer::addInterleavedAttribute(std::vector<InterleavedSource>& sources, size_t offset, GlUtils::array_view<T> a0)
+{
+    assert(a0.size() == _numVertices);
+
+    // Saves the properties of the current attribute, the stride is set once all attributes are known
+    VertexAttribute attribute = createAttribute<T>(_attributes.size());
+    attribute.pointer = offset;
+    _attributes.push_back(attribute);
+
+    InterleavedSource source;
+    source.data = reinterpret_cast<const char*>(a0.data());
+    source.size = sizeof(T);
+    source.offset = offset;
+    sources.push_back(source);
+
+    // keep the next attribute 4 byte aligned
+    return (offset + sizeof(T) + 3) / 4 * 4;
+}
+
+template<typename T, typename... U>
+size_t GlVertexBuffer::addInterleavedAttribute(std::vector<InterleavedSource>& sources, size_t offset, GlUtils::array_view<T> a0, GlUtils::array_view<U>... a)
+{
+    offset = addInterleavedAttribute(sources, offset, a0);
+    return addInterleavedAttribute(sources, offset, a...);
+}
+
 #endif // GLVERTEXBUFFER_H
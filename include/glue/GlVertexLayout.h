@@ -0,0 +1,183 @@
+#ifndef GLVERTEXLAYOUT_H
+#define GLVERTEXLAYOUT_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlVertexBuffer.h"
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+namespace GlUtils
+{
+namespace detail
+{
+    /// Size in bytes of a single component of the given type
+    constexpr size_t componentSize(GlVertexBuffer::VertexAttribute::Type type)
+    {
+        return type == GlVertexBuffer::VertexAttribute::Byte || type == GlVertexBuffer::VertexAttribute::UnsignedByte ? 1 :
+               type == GlVertexBuffer::VertexAttribute::Short || type == GlVertexBuffer::VertexAttribute::UnsignedShort ||
+               type == GlVertexBuffer::VertexAttribute::HalfFloat ? 2 : 4;
+    }
+
+    /// Size in bytes of an attribute value with the given type and number of components
+    constexpr size_t attributeSize(GlVertexBuffer::VertexAttribute::Type type, int components)
+    {
+        // packed types store all components in a single 32 bit value
+        return type == GlVertexBuffer::VertexAttribute::Int2101010Rev || type == GlVertexBuffer::VertexAttribute::UnsignedInt2101010Rev ?
+                    4 : components * componentSize(type);
+    }
+
+    /// Checks the format of a single attribute type T at compile time
+    template<typename T>
+    struct LayoutAttribute
+    {
+        static_assert(sizeof(T) == attributeSize(GlVertexFormat<T>::type, GlVertexFormat<T>::components),
+                      "Size of the vertex attribute type does not match its GlVertexFormat");
+        static_assert(sizeof(T) % 4 == 0 && alignof(T) <= 4,
+                      "Vertex attributes in an interleaved layout must be 4 byte aligned");
+        static constexpr size_t size = sizeof(T);
+    };
+
+    /// Sum of the sizes of all attributes
+    template<typename... T>
+    struct LayoutSize;
+
+    template<>
+    struct LayoutSize<>
+    {
+        static constexpr size_t value = 0;
+    };
+
+    template<typename T, typename... U>
+    struct LayoutSize<T, U...>
+    {
+        static constexpr size_t value = LayoutAttribute<T>::size + LayoutSize<U...>::value;
+    };
+
+    /// Offset of the attribute with index I
+    template<size_t I, typename... T>
+    struct LayoutOffset;
+
+    template<typename T, typename... U>
+    struct LayoutOffset<0, T, U...>
+    {
+        static constexpr size_t value = 0;
+    };
+
+    template<size_t I, typename T, typename... U>
+    struct LayoutOffset<I, T, U...>
+    {
+        static constexpr size_t value = LayoutAttribute<T>::size + LayoutOffset<I-1, U...>::value;
+    };
+
+    /// Type of the attribute with index I
+    template<size_t I, typename... T>
+    struct LayoutType;
+
+    template<typename T, typename... U>
+    struct LayoutType<0, T, U...>
+    {
+        typedef T type;
+    };
+
+    template<size_t I, typename T, typename... U>
+    struct LayoutType<I, T, U...>
+    {
+        typedef typename LayoutType<I-1, U...>::type type;
+    };
+
+    /// Appends the VertexAttributes of all types starting at Offset
+    template<size_t Offset, typename... T>
+    struct LayoutBuilder;
+
+    template<size_t Offset>
+    struct LayoutBuilder<Offset>
+    {
+        static void append(std::vector<GlVertexBuffer::VertexAttribute>&, unsigned int, size_t) {}
+    };
+
+    template<size_t Offset, typename T, typename... U>
+    struct LayoutBuilder<Offset, T, U...>
+    {
+        static void append(std::vector<GlVertexBuffer::VertexAttribute>& attributes, unsigned int index, size_t stride)
+        {
+            GlVertexBuffer::VertexAttribute attribute(index, GlVertexFormat<T>::components, GlVertexFormat<T>::type, GlVertexFormat<T>::normalized, GlVertexFormat<T>::integer);
+            attribute.stride = stride;
+            attribute.pointer = Offset;
+            attributes.push_back(attribute);
+            LayoutBuilder<Offset + LayoutAttribute<T>::size, U...>::append(attributes, index+1, stride);
+        }
+    };
+}
+}
+
+/**
+ * The GlVertexLayout class describes the interleaved layout of a vertex at compile time.
+ * The template arguments are the types of the attributes in the order they appear in the vertex
+ * (and the order of the attribute indices).
+ * Offsets, stride and formats (see \ref GlVertexFormat) are computed by the compiler.
+ * Types that are not supported, don't match their format or are not 4 byte aligned fail to compile.
+ * \ref GLUE_VERTEX_LAYOUT_CHECK verifies that a member of a vertex struct is placed where the layout expects it.
+ *
+ * \code
+ * struct Vertex
+ * {
+ *     glm::vec3 position;
+ *     glm::vec3 normal;
+ *     glm::vec2 texCoord;
+ * };
+ * typedef GlVertexLayout<glm::vec3, glm::vec3, glm::vec2> VertexLayout;
+ * GLUE_VERTEX_LAYOUT_CHECK(VertexLayout, Vertex, 0, position);
+ * GLUE_VERTEX_LAYOUT_CHECK(VertexLayout, Vertex, 1, normal);
+ * GLUE_VERTEX_LAYOUT_CHECK(VertexLayout, Vertex, 2, texCoord);
+ *
+ * std::vector<Vertex> vertices = ...
+ * vbo.setInterleavedData<VertexLayout>(GlBuffer::Usage::StaticDraw, vertices);
+ * vao.setVertexData(vbo);
+ * \endcode
+ */
+template<typename... Attributes>
+struct GlVertexLayout
+{
+    static_assert(sizeof...(Attributes) > 0, "A vertex layout requires at least one attribute");
+
+    /// Number of attributes per vertex
+    static constexpr size_t numAttributes = sizeof...(Attributes);
+
+    /// Size of a vertex in bytes
+    static constexpr size_t stride = GlUtils::detail::LayoutSize<Attributes...>::value;
+
+    /// Returns the byte offset of the attribute with index I inside a vertex
+    template<size_t I>
+    static constexpr size_t offset()
+    {
+        static_assert(I < sizeof...(Attributes), "Attribute index out of range");
+        return GlUtils::detail::LayoutOffset<I, Attributes...>::value;
+    }
+
+    /// Type of the attribute with index I
+    template<size_t I>
+    using type = typename GlUtils::detail::LayoutType<I, Attributes...>::type;
+
+    /**
+     * Returns the VertexAttributes of the layout.
+     * The first attribute gets firstIndex as index, the following are numbered consecutively.
+     */
+    static std::vector<GlVertexBuffer::VertexAttribute> attributes(unsigned int firstIndex=0)
+    {
+        std::vector<GlVertexBuffer::VertexAttribute> result;
+        result.reserve(numAttributes);
+        GlUtils::detail::LayoutBuilder<0, Attributes...>::append(result, firstIndex, stride);
+        return result;
+    }
+};
+
+/// Fails to compile if member of the vertex struct does not have the type and offset of attribute I of the layout
+#define GLUE_VERTEX_LAYOUT_CHECK(Layout, Vertex, I, member) \
+    static_assert(std::is_same<decltype(Vertex::member), Layout::type<I>>::value, \
+                  #Vertex "::" #member " does not have the type of attribute " #I " of " #Layout); \
+    static_assert(offsetof(Vertex, member) == Layout::offset<I>(), \
+                  #Vertex "::" #member " is not placed at the offset of attribute " #I " of " #Layout)
+
+#endif // GLVERTEXLAYOUT_H
@@ -0,0 +1,90 @@
+#ifndef GLVERTEXPACKING_H
+#define GLVERTEXPACKING_H
+
+#include "glue/GlConfig.h"
+#include "glue/GlVertexBuffer.h"
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Compact vertex attribute types and converters from float data.
+ * Quantized attributes reduce the memory footprint and the vertex fetch bandwidth,
+ * e.g. a normal stored as \ref GlUtils::packed_snorm uses 4 instead of 12 bytes.
+ * All types have a \ref GlVertexFormat and can be passed directly to \ref GlVertexBuffer::setData or used in a \ref GlVertexLayout.
+ *
+ * \code
+ * std::vector<glm::vec3> normals = ...
+ * std::vector<GlUtils::packed_snorm> packed(normals.size());
+ * GlUtils::pack_snorm_2_10_10_10(&normals[0].x, normals.size(), packed.data());
+ * vbo.setData(GlBuffer::Usage::StaticDraw, positions, packed);
+ * \endcode
+ */
+namespace GlUtils
+{
+    /// Two half floats
+    struct half2 { uint16_t x, y; };
+    /// Four half floats
+    struct half4 { uint16_t x, y, z, w; };
+    /// Two signed 16 bit values normalized to [-1,1]
+    struct snorm16x2 { int16_t x, y; };
+    /// Four signed 16 bit values normalized to [-1,1]
+    struct snorm16x4 { int16_t x, y, z, w; };
+    /// Two unsigned 16 bit values normalized to [0,1]
+    struct unorm16x2 { uint16_t x, y; };
+    /// Four unsigned 16 bit values normalized to [0,1]
+    struct unorm16x4 { uint16_t x, y, z, w; };
+    /// Four signed 8 bit values normalized to [-1,1]
+    struct snorm8x4 { int8_t x, y, z, w; };
+    /// Four unsigned 8 bit values normalized to [0,1] (e.g. colors)
+    struct unorm8x4 { uint8_t x, y, z, w; };
+    /// Four signed values normalized to [-1,1] packed into 10, 10, 10 and 2 bits (e.g. normals and tangents)
+    struct packed_snorm { uint32_t value; };
+
+    /**
+     * Converts count floats to half floats with round to nearest even.
+     * Uses the F16C instructions if the compiler targets them.
+     */
+    void pack_half(const float* src, size_t count, uint16_t* dst);
+
+    /// Converts count floats to signed normalized 16 bit values, values are clamped to [-1,1].
+    void pack_snorm16(const float* src, size_t count, int16_t* dst);
+
+    /// Converts count floats to unsigned normalized 16 bit values, values are clamped to [0,1].
+    void pack_unorm16(const float* src, size_t count, uint16_t* dst);
+
+    /// Converts count floats to signed normalized 8 bit values, values are clamped to [-1,1].
+    void pack_snorm8(const float* src, size_t count, int8_t* dst);
+
+    /// Converts count floats to unsigned normalized 8 bit values, values are clamped to [0,1].
+    void pack_unorm8(const float* src, size_t count, uint8_t* dst);
+
+    /**
+     * Packs count vectors with three components (e.g. normals) to the signed 2_10_10_10 format.
+     * The fourth component is set to w (e.g. the handedness of a tangent).
+     */
+    void pack_snorm_2_10_10_10(const float* xyz, size_t count, packed_snorm* dst, float w=0.0f);
+
+    /**
+     * Encodes count unit vectors with three components with the octahedral mapping into two signed normalized 16 bit values.
+     * The shader has to decode the normal:
+     * \code
+     * vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+     * if(n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+     * n = normalize(n);
+     * \endcode
+     */
+    void pack_octahedral(const float* xyz, size_t count, snorm16x2* dst);
+}
+
+template<> struct GlVertexFormat<GlUtils::half2>: GlVertexFormatBase<2, GlVertexBuffer::VertexAttribute::HalfFloat> {};
+template<> struct GlVertexFormat<GlUtils::half4>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::HalfFloat> {};
+template<> struct GlVertexFormat<GlUtils::snorm16x2>: GlVertexFormatBase<2, GlVertexBuffer::VertexAttribute::Short, true> {};
+template<> struct GlVertexFormat<GlUtils::snorm16x4>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::Short, true> {};
+template<> struct GlVertexFormat<GlUtils::unorm16x2>: GlVertexFormatBase<2, GlVertexBuffer::VertexAttribute::UnsignedShort, true> {};
+template<> struct GlVertexFormat<GlUtils::unorm16x4>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::UnsignedShort, true> {};
+template<> struct GlVertexFormat<GlUtils::snorm8x4>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::Byte, true> {};
+template<> struct GlVertexFormat<GlUtils::unorm8x4>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::UnsignedByte, true> {};
+template<> struct GlVertexFormat<GlUtils::packed_snorm>: GlVertexFormatBase<4, GlVertexBuffer::VertexAttribute::Int2101010Rev, true> {};
+
+#endif // GLVERTEXPACKING_H
@@ -0,0 +1,91 @@
+#include <glue/GlProgram.h>
+#include <glue/GlBuffer.h>
+#include <glue/GlMemoryBarrier.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common.h"
+
+// Counts the values of a buffer in 256 bins with atomics, one invocation per value.
+const char* histogramSource = R"(
+#version 430
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer Values { uint values[]; };
+layout(std430, binding = 1) buffer Histogram { uint bins[]; };
+
+uniform int count;
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if(i < uint(count))
+        atomicAdd(bins[values[i] & 255u], 1u);
+}
+)";
+
+int main()
+{
+    auto window = createWindow(64, 64);
+    if(!window)
+    {
+        LOG(ERROR) <<  "Failed to create window";
+        glfwTerminate();
+        return -1;
+    }
+
+    if(!GLAD_GL_ARB_compute_shader || !GLAD_GL_ARB_shader_storage_buffer_object)
+    {
+        LOG(ERROR) << "Compute shaders are not supported";
+        glfwTerminate();
+        return -1;
+    }
+
+    const size_t numValues = 1000000;
+    std::vector<unsigned int> values(numValues);
+    std::mt19937 random(42);
+    for(auto& value: values)
+        value = random() & 255u;
+
+    std::vector<unsigned int> expected(256, 0);
+    for(auto value: values)
+        ++expected[value];
+
+    GlBuffer valueBuffer(GlBuffer::Target::ShaderStorage);
+    valueBuffer.bind();
+    valueBuffer.setData(GlBuffer::Usage::StaticDraw, values.data(), values.size() * sizeof(unsigned int));
+
+    std::vector<unsigned int> zeros(256, 0);
+    GlBuffer histogramBuffer(GlBuffer::Target::ShaderStorage);
+    histogramBuffer.bind();
+    histogramBuffer.setData(GlBuffer::Usage::DynamicRead, zeros.data(), zeros.size() * sizeof(unsigned int));
+
+    GlProgram histogram(histogramSource);
+    auto size = histogram.workGroupSize();
+    LOG(INFO) << "Work group size " << size[0] << "x" << size[1] << "x" << size[2];
+
+    valueBuffer.bindBase(0);
+    histogramBuffer.bindBase(1);
+    histogram.activate();
+    histogram.setUniform("count", static_cast<int>(numValues));
+    histogram.dispatchInvocations(static_cast<unsigned int>(numValues));
+
+    // the atomics must be visible to the buffer mapping
+    GlMemoryBarrier::insert(GlMemoryBarrier::BufferUpdate);
+
+    std::vector<unsigned int> bins(256);
+    const void* data = histogramBuffer.map(0, bins.size() * sizeof(unsigned int), GlBuffer::MapRead);
+    std::memcpy(bins.data(), data, bins.size() * sizeof(unsigned int));
+    histogramBuffer.unmap();
+
+    const bool correct = bins == expected;
+    LOG(INFO) << "Histogram of " << numValues << " values is " << (correct ? "correct" : "wrong");
+
+    glfwTerminate();
+    return correct ? 0 : 1;
+}
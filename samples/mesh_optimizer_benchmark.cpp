@@ -0,0 +1,133 @@
+#include <glue/GlMeshOptimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+struct Mesh
+{
+    std::string name;
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+
+    size_t numVertices() const { return positions.size() / 3; }
+};
+
+Mesh createGrid(unsigned int size)
+{
+    Mesh mesh;
+    mesh.name = "grid";
+    for(unsigned int y=0; y<=size; ++y)
+    {
+        for(unsigned int x=0; x<=size; ++x)
+        {
+            mesh.positions.insert(mesh.positions.end(), {float(x), float(y), 0.0f});
+        }
+    }
+    for(unsigned int y=0; y<size; ++y)
+    {
+        for(unsigned int x=0; x<size; ++x)
+        {
+            const unsigned int a = y * (size + 1) + x;
+            const unsigned int c = a + size + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, a+1, c, a+1, c+1, c});
+        }
+    }
+    return mesh;
+}
+
+Mesh createSphere(unsigned int rings, unsigned int segments)
+{
+    Mesh mesh;
+    mesh.name = "sphere";
+    const float pi = 3.14159265f;
+    for(unsigned int r=0; r<=rings; ++r)
+    {
+        const float theta = pi * r / rings;
+        for(unsigned int s=0; s<=segments; ++s)
+        {
+            const float phi = 2.0f * pi * s / segments;
+            mesh.positions.insert(mesh.positions.end(), {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+        }
+    }
+    for(unsigned int r=0; r<rings; ++r)
+    {
+        for(unsigned int s=0; s<segments; ++s)
+        {
+            const unsigned int a = r * (segments + 1) + s;
+            const unsigned int c = a + segments + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, c, a+1, a+1, c, c+1});
+        }
+    }
+    return mesh;
+}
+
+// exporters often write triangles in an order unrelated to the topology
+void shuffleTriangles(Mesh& mesh)
+{
+    std::vector<size_t> order(mesh.indices.size() / 3);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    std::vector<unsigned int> shuffled;
+    shuffled.reserve(mesh.indices.size());
+    for(auto t: order)
+        shuffled.insert(shuffled.end(), mesh.indices.begin() + 3*t, mesh.indices.begin() + 3*t + 3);
+    mesh.indices.swap(shuffled);
+}
+
+void report(const Mesh& mesh, const char* stage)
+{
+    for(unsigned int cacheSize: {16u, 32u})
+    {
+        auto stats = GlUtils::analyze_vertex_cache(mesh.indices.data(), mesh.indices.size(), mesh.numVertices(), cacheSize);
+        LOG(INFO) << mesh.name << " " << stage << " (cache " << cacheSize << "): "
+                  << "ACMR " << stats.acmr << ", ATVR " << stats.atvr;
+    }
+}
+
+int main()
+{
+    std::vector<Mesh> meshes;
+    meshes.push_back(createGrid(300));
+    meshes.push_back(createSphere(200, 400));
+
+    for(auto& mesh: meshes)
+    {
+        shuffleTriangles(mesh);
+        report(mesh, "unoptimized");
+
+        auto start = std::chrono::steady_clock::now();
+        GlUtils::optimize_vertex_cache(mesh.indices.data(), mesh.indices.size(), mesh.numVertices());
+        auto cacheDone = std::chrono::steady_clock::now();
+        report(mesh, "vertex cache");
+
+        GlUtils::optimize_overdraw(mesh.indices.data(), mesh.indices.size(), mesh.positions.data(), mesh.numVertices(), 3 * sizeof(float));
+        auto overdrawDone = std::chrono::steady_clock::now();
+        report(mesh, "overdraw");
+
+        std::vector<unsigned int> remap;
+        size_t numVertices = GlUtils::optimize_vertex_fetch(mesh.indices.data(), mesh.indices.size(), mesh.numVertices(), remap);
+        std::vector<std::array<float, 3>> positions(mesh.numVertices());
+        std::copy(mesh.positions.begin(), mesh.positions.end(), &positions[0][0]);
+        GlUtils::remap_vertex_attributes(remap, numVertices, positions);
+        mesh.positions.assign(&positions[0][0], &positions[0][0] + 3 * numVertices);
+        auto fetchDone = std::chrono::steady_clock::now();
+        report(mesh, "vertex fetch");
+
+        typedef std::chrono::duration<double, std::milli> ms;
+        LOG(INFO) << mesh.name << ": " << mesh.indices.size() / 3 << " triangles, "
+                  << "vertex cache " << ms(cacheDone - start).count() << " ms, "
+                  << "overdraw " << ms(overdrawDone - cacheDone).count() << " ms, "
+                  << "vertex fetch " << ms(fetchDone - overdrawDone).count() << " ms";
+    }
+
+    return 0;
+}
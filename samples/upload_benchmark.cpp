@@ -0,0 +1,105 @@
+#include <glue/GlBuffer.h>
+#include <glue/GlVertexBuffer.h>
+#include <glue/GlUtils.h>
+
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <vector>
+
+#include "common.h"
+
+// Reproduces the previous GlVertexBuffer::setData that took every vector by value
+// and therefore copied each attribute once per recursion level.
+template<typename T>
+size_t byValueSize(std::vector<T> a0)
+{
+    return a0.size() * sizeof(T);
+}
+
+template<typename T, typename... U>
+size_t byValueSize(std::vector<T> a0, std::vector<U>... a)
+{
+    return a0.size() * sizeof(T) + byValueSize(a...);
+}
+
+template<typename T>
+void byValueSubData(GlBuffer& buffer, size_t offset, std::vector<T> a0)
+{
+    buffer.setSubData(&a0[0], byValueSize(a0), offset);
+}
+
+template<typename T, typename... U>
+void byValueSubData(GlBuffer& buffer, size_t offset, std::vector<T> a0, std::vector<U>... a)
+{
+    buffer.setSubData(&a0[0], byValueSize(a0), offset);
+    byValueSubData(buffer, offset + byValueSize(a0), a...);
+}
+
+template<typename T, typename... U>
+void byValueSetData(GlBuffer& buffer, std::vector<T> a0, std::vector<U>... a)
+{
+    buffer.setData(GlBuffer::Usage::StaticDraw, nullptr, byValueSize(a0, a...));
+    byValueSubData(buffer, 0, a0, a...);
+}
+
+template<typename F>
+double measure(F f)
+{
+    // glFinish makes sure the driver actually consumed the data
+    auto start = std::chrono::steady_clock::now();
+    f();
+    glFinish();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+    auto window = createWindow(64, 64);
+    if(!window)
+    {
+        LOG(ERROR) <<  "Failed to create window";
+        glfwTerminate();
+        return -1;
+    }
+
+    for(size_t numVertices: {1000000u, 5000000u, 20000000u})
+    {
+        std::vector<glm::vec3> positions(numVertices, glm::vec3(1.0f, 2.0f, 3.0f));
+        std::vector<glm::vec3> normals(numVertices, glm::vec3(0.0f, 0.0f, 1.0f));
+        std::vector<glm::vec4> colors(numVertices, glm::vec4(1.0f));
+        std::vector<float> intensities(numVertices, 0.5f);
+
+        GlVertexBuffer vbo;
+        vbo.bind();
+
+        double byValue = measure([&]()
+        {
+            byValueSetData(vbo, positions, normals, colors, intensities);
+        });
+        double byReference = measure([&]()
+        {
+            vbo.setData(GlBuffer::Usage::StaticDraw, positions, normals, colors, intensities);
+        });
+        double byView = measure([&]()
+        {
+            vbo.setData(GlBuffer::Usage::StaticDraw,
+                        GlUtils::make_view(positions.data(), positions.size()),
+                        GlUtils::make_view(normals.data(), normals.size()),
+                        GlUtils::make_view(colors.data(), colors.size()),
+                        GlUtils::make_view(intensities.data(), intensities.size()));
+        });
+
+        vbo.release();
+
+        LOG(INFO) << numVertices << " vertices: by value " << byValue << " ms, "
+                  << "by reference " << byReference << " ms, "
+                  << "by view " << byView << " ms";
+    }
+
+    glfwTerminate();
+    return 0;
+}
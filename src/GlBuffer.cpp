@@ -1,4 +1,5 @@
 #include "glue/GlBuffer.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 #include <cassert>
 
@@ -8,56 +9,141 @@ GlBuffer::GlBuffer(Target target):
 	_size(0),
     _usage(Usage::StaticDraw)
 {
-	GL_SAFE_CALL(glGenBuffers(1, &_id));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glCreateBuffers(1, &_id));
+    }
+    else
+    {
+        GL_SAFE_CALL(glGenBuffers(1, &_id));
+    }
 }
 
 GlBuffer::~GlBuffer()
 {
 	GL_SAFE_CALL(glDeleteBuffers(1, &_id));
+    GlState::current().bufferDeleted(_id);
 }
 
 void GlBuffer::bind()
 {
-    GL_SAFE_CALL(glBindBuffer(mapBufferTarget(_target), _id));
+    GlState::current().bindBuffer(_target, _id);
 }
 
 void GlBuffer::release()
 {
-    GL_SAFE_CALL(glBindBuffer(mapBufferTarget(_target), 0));
+    GlState::current().bindBuffer(_target, 0);
+}
+
+void GlBuffer::bindBase(unsigned int index)
+{
+    GlState::current().bindBufferBase(_target, index, _id);
+}
+
+void GlBuffer::bindRange(unsigned int index, size_t offset, size_t size)
+{
+    assert(offset + size <= _size);
+    GlState::current().bindBufferRange(_target, index, _id, offset, size);
 }
 
 bool GlBuffer::isBound() const
 {
-    int currentId = -1;
-    GLenum target;
-    switch (_target) {
-    case Target::Array:
-        target = GL_ARRAY_BUFFER_BINDING;
-        break;
-    case Target::ElementArray:
-        target = GL_ELEMENT_ARRAY_BUFFER_BINDING;
-        break;
-    }
-    GL_SAFE_CALL(glGetIntegerv(target, &currentId));
-    return currentId == (GLint)_id;
+    return GlState::current().isBufferBound(_target, _id);
+}
+
+unsigned int GlBuffer::id() const
+{
+    return _id;
+}
+
+GlBuffer::Target GlBuffer::target() const
+{
+    return _target;
 }
 
-void GlBuffer::setData(Usage usage, void* data, size_t size)
+size_t GlBuffer::size() const
 {
+    return _size;
+}
+
+void GlBuffer::setData(Usage usage, const void* data, size_t size)
+{
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedBufferData(_id, (GLsizeiptr)size, data, mapBufferUsage(usage)));
+    }
+    else
+    {
 #ifdef GLUE_LOGGING
-    if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
+        if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
 #endif
-
-    GL_SAFE_CALL(glBufferData(mapBufferTarget(_target), (GLsizei)size, (GLvoid*)data, mapBufferUsage(usage)));
+        GL_SAFE_CALL(glBufferData(mapBufferTarget(_target), (GLsizeiptr)size, data, mapBufferUsage(usage)));
+    }
     _size = size;
 }
 
-void GlBuffer::setSubData(void* data, size_t size, size_t offset)
+void GlBuffer::setSubData(const void* data, size_t size, size_t offset)
 {
+    assert(offset+size <= _size);
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedBufferSubData(_id, (GLintptr)offset, (GLsizeiptr)size, data));
+    }
+    else
+    {
 #ifdef GLUE_LOGGING
-    if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
+        if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
 #endif
+        GL_SAFE_CALL(glBufferSubData(mapBufferTarget(_target), (GLintptr)offset, (GLsizeiptr)size, data));
+    }
+}
 
+void* GlBuffer::map(size_t offset, size_t size, unsigned int access)
+{
     assert(offset+size <= _size);
-    GL_SAFE_CALL(glBufferSubData(mapBufferTarget(_target), (GLintptr)offset, (GLsizei)size, (GLvoid*)data));
+    void* data = nullptr;
+    if(useDirectStateAccess())
+    {
+        data = GL_SAFE_CALL(glMapNamedBufferRange(_id, (GLintptr)offset, (GLsizeiptr)size, mapBufferAccess(access)));
+    }
+    else
+    {
+#ifdef GLUE_LOGGING
+        if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
+#endif
+        data = GL_SAFE_CALL(glMapBufferRange(mapBufferTarget(_target), (GLintptr)offset, (GLsizeiptr)size, mapBufferAccess(access)));
+    }
+    return data;
+}
+
+bool GlBuffer::unmap()
+{
+    GLboolean valid = GL_FALSE;
+    if(useDirectStateAccess())
+    {
+        valid = GL_SAFE_CALL(glUnmapNamedBuffer(_id));
+    }
+    else
+    {
+#ifdef GLUE_LOGGING
+        if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
+#endif
+        valid = GL_SAFE_CALL(glUnmapBuffer(mapBufferTarget(_target)));
+    }
+    return valid == GL_TRUE;
+}
+
+void GlBuffer::flushRange(size_t offset, size_t size)
+{
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glFlushMappedNamedBufferRange(_id, (GLintptr)offset, (GLsizeiptr)size));
+    }
+    else
+    {
+#ifdef GLUE_LOGGING
+        if(!isBound()) LOG(DEBUG) << "Buffer is not bound!";
+#endif
+        GL_SAFE_CALL(glFlushMappedBufferRange(mapBufferTarget(_target), (GLintptr)offset, (GLsizeiptr)size));
+    }
 }
@@ -0,0 +1,333 @@
+#include "glue/GlBufferArena.h"
+#include "glue/GlInternal.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+    inline size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+const GlBufferArena::Handle GlBufferArena::InvalidHandle = std::numeric_limits<GlBufferArena::Handle>::max();
+
+float GlBufferArena::Statistics::fragmentation() const
+{
+    return free > 0 ? 1.0f - static_cast<float>(largestFree) / static_cast<float>(free) : 0.0f;
+}
+
+GlBufferArena::GlBufferArena(GlBuffer::Target target, size_t blockSize, GlBuffer::Usage usage):
+    _target(target),
+    _blockSize(blockSize),
+    _usage(usage)
+{
+    assert(blockSize > 0);
+}
+
+GlBufferArena::~GlBufferArena()
+{
+
+}
+
+GlBufferArena::Handle GlBufferArena::allocate(size_t size, size_t alignment)
+{
+    assert(size > 0 && alignment > 0);
+
+    // best fit over the free ranges of all blocks
+    unsigned int bestBlock = 0;
+    size_t bestOffset = 0;
+    size_t bestWaste = std::numeric_limits<size_t>::max();
+    std::map<size_t, size_t>::iterator bestRange;
+    for(unsigned int b=0; b<_blocks.size(); ++b)
+    {
+        auto& freeRanges = _blocks[b].freeRanges;
+        for(auto range=freeRanges.begin(); range!=freeRanges.end(); ++range)
+        {
+            const size_t offset = alignUp(range->first, alignment);
+            if(offset + size > range->first + range->second)
+                continue;
+            const size_t waste = range->second - size;
+            if(waste < bestWaste)
+            {
+                bestBlock = b;
+                bestOffset = offset;
+                bestWaste = waste;
+                bestRange = range;
+            }
+        }
+    }
+
+    if(bestWaste == std::numeric_limits<size_t>::max())
+    {
+        bestBlock = addBlock(std::max(size, _blockSize));
+        bestRange = _blocks[bestBlock].freeRanges.begin();
+        bestOffset = 0;
+    }
+
+    // split the range, the alignment gap and the remainder stay free
+    Block& block = _blocks[bestBlock];
+    const size_t rangeOffset = bestRange->first;
+    const size_t rangeEnd = bestRange->first + bestRange->second;
+    block.freeRanges.erase(bestRange);
+    if(bestOffset > rangeOffset)
+        block.freeRanges[rangeOffset] = bestOffset - rangeOffset;
+    if(bestOffset + size < rangeEnd)
+        block.freeRanges[bestOffset + size] = rangeEnd - (bestOffset + size);
+
+    Allocation allocation;
+    allocation.block = bestBlock;
+    allocation.offset = bestOffset;
+    allocation.size = size;
+    allocation.alignment = alignment;
+    allocation.live = true;
+
+    Handle handle;
+    if(!_freeHandles.empty())
+    {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+        _allocations[handle] = allocation;
+    }
+    else
+    {
+        handle = _allocations.size();
+        _allocations.push_back(allocation);
+    }
+    return handle;
+}
+
+void GlBufferArena::free(Handle handle)
+{
+    assert(handle < _allocations.size() && _allocations[handle].live);
+    Allocation& a = _allocations[handle];
+
+    releaseRange(_blocks[a.block], a.offset, a.size);
+    a.live = false;
+    _freeHandles.push_back(handle);
+}
+
+void GlBufferArena::setSubData(Handle handle, const void* data, size_t size, size_t offset)
+{
+    const Allocation& a = allocation(handle);
+    assert(offset + size <= a.size);
+
+    GlBuffer& buffer = *_blocks[a.block].buffer;
+    if(!useDirectStateAccess())
+        buffer.bind();
+    buffer.setSubData(data, size, a.offset + offset);
+}
+
+GlBuffer& GlBufferArena::buffer(Handle handle) const
+{
+    return *_blocks[allocation(handle).block].buffer;
+}
+
+unsigned int GlBufferArena::blockIndex(Handle handle) const
+{
+    return allocation(handle).block;
+}
+
+size_t GlBufferArena::offset(Handle handle) const
+{
+    return allocation(handle).offset;
+}
+
+size_t GlBufferArena::size(Handle handle) const
+{
+    return allocation(handle).size;
+}
+
+size_t GlBufferArena::firstElement(Handle handle, size_t elementSize) const
+{
+    const Allocation& a = allocation(handle);
+    assert(elementSize > 0 && a.offset % elementSize == 0);
+    return a.offset / elementSize;
+}
+
+size_t GlBufferArena::numBlocks() const
+{
+    return _blocks.size();
+}
+
+GlBuffer& GlBufferArena::block(size_t index) const
+{
+    return *_blocks[index].buffer;
+}
+
+void GlBufferArena::compact()
+{
+    // a block is fragmented if its free memory is not a single range at its end
+    std::vector<unsigned int> fragmented;
+    size_t scratchSize = 0;
+    for(unsigned int b=0; b<_blocks.size(); ++b)
+    {
+        const Block& block = _blocks[b];
+        if(block.freeRanges.empty())
+            continue;
+        const auto& last = *block.freeRanges.rbegin();
+        if(block.freeRanges.size() > 1 || last.first + last.second != block.size)
+        {
+            fragmented.push_back(b);
+            scratchSize = std::max(scratchSize, block.size);
+        }
+    }
+    if(fragmented.empty())
+        return;
+
+    // allocations are packed into a scratch buffer and copied back, since glCopyBufferSubData must not copy between overlapping ranges
+    GlBuffer scratch(_target);
+    if(useDirectStateAccess())
+    {
+        scratch.setData(GlBuffer::Usage::StreamCopy, nullptr, scratchSize);
+    }
+    else
+    {
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, scratch.id()));
+        GL_SAFE_CALL(glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)scratchSize, nullptr, GL_STREAM_COPY));
+    }
+
+    for(auto b: fragmented)
+        compactBlock(b, scratch);
+
+    if(!useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+    }
+}
+
+GlBufferArena::Statistics GlBufferArena::statistics() const
+{
+    Statistics statistics;
+    statistics.capacity = 0;
+    statistics.used = 0;
+    statistics.free = 0;
+    statistics.largestFree = 0;
+    statistics.numFreeRanges = 0;
+    statistics.numAllocations = _allocations.size() - _freeHandles.size();
+    statistics.numBlocks = _blocks.size();
+
+    for(const auto& block: _blocks)
+    {
+        statistics.capacity += block.size;
+        statistics.numFreeRanges += block.freeRanges.size();
+        for(const auto& range: block.freeRanges)
+        {
+            statistics.free += range.second;
+            statistics.largestFree = std::max(statistics.largestFree, range.second);
+        }
+    }
+    for(const auto& a: _allocations)
+    {
+        if(a.live)
+            statistics.used += a.size;
+    }
+    return statistics;
+}
+
+unsigned int GlBufferArena::addBlock(size_t size)
+{
+    Block block;
+    block.buffer.reset(new GlBuffer(_target));
+    block.size = size;
+    block.freeRanges[0] = size;
+
+    if(!useDirectStateAccess())
+        block.buffer->bind();
+    block.buffer->setData(_usage, nullptr, size);
+
+    _blocks.push_back(std::move(block));
+    return _blocks.size() - 1;
+}
+
+void GlBufferArena::releaseRange(Block& block, size_t offset, size_t size)
+{
+    auto next = block.freeRanges.lower_bound(offset);
+    // merge with the following range
+    if(next != block.freeRanges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = block.freeRanges.erase(next);
+    }
+    // merge with the preceding range
+    if(next != block.freeRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if(previous->first + previous->second == offset)
+        {
+            previous->second += size;
+            return;
+        }
+    }
+    block.freeRanges[offset] = size;
+}
+
+void GlBufferArena::compactBlock(unsigned int index, GlBuffer& scratch)
+{
+    Block& block = _blocks[index];
+
+    std::vector<Allocation*> live;
+    for(auto& a: _allocations)
+    {
+        if(a.live && a.block == index)
+            live.push_back(&a);
+    }
+    std::sort(live.begin(), live.end(), [](const Allocation* a, const Allocation* b) { return a->offset < b->offset; });
+
+    const bool dsa = useDirectStateAccess();
+    if(!dsa)
+    {
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_READ_BUFFER, block.buffer->id()));
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, scratch.id()));
+    }
+
+    // allocations in front of the first gap stay in place and are not copied
+    block.freeRanges.clear();
+    size_t cursor = 0;
+    size_t firstMoved = block.size;
+    for(auto a: live)
+    {
+        const size_t offset = alignUp(cursor, a->alignment);
+        if(offset > cursor)
+            block.freeRanges[cursor] = offset - cursor;
+        // once an allocation moved, all following ones are packed too since the range is copied back at once
+        if(firstMoved < block.size || offset != a->offset)
+        {
+            firstMoved = std::min(firstMoved, offset);
+            if(dsa)
+            {
+                GL_SAFE_CALL(glCopyNamedBufferSubData(block.buffer->id(), scratch.id(), (GLintptr)a->offset, (GLintptr)offset, (GLsizeiptr)a->size));
+            }
+            else
+            {
+                GL_SAFE_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)a->offset, (GLintptr)offset, (GLsizeiptr)a->size));
+            }
+            a->offset = offset;
+        }
+        cursor = offset + a->size;
+    }
+    if(cursor < block.size)
+        block.freeRanges[cursor] = block.size - cursor;
+
+    if(firstMoved < cursor && dsa)
+    {
+        GL_SAFE_CALL(glCopyNamedBufferSubData(scratch.id(), block.buffer->id(), (GLintptr)firstMoved, (GLintptr)firstMoved, (GLsizeiptr)(cursor - firstMoved)));
+    }
+    else if(firstMoved < cursor)
+    {
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_READ_BUFFER, scratch.id()));
+        GL_SAFE_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, block.buffer->id()));
+        GL_SAFE_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)firstMoved, (GLintptr)firstMoved, (GLsizeiptr)(cursor - firstMoved)));
+    }
+}
+
+const GlBufferArena::Allocation& GlBufferArena::allocation(Handle handle) const
+{
+    assert(handle < _allocations.size() && _allocations[handle].live);
+    return _allocations[handle];
+}
@@ -0,0 +1,147 @@
+#include "glue/GlDebug.h"
+#include "glue/GlInternal.h"
+
+unsigned int glErrorCheckInterval = 1;
+thread_local unsigned int glErrorCheckCounter = 0;
+
+namespace
+{
+    bool outputEnabled = false;
+    unsigned int savedErrorCheckInterval = 1; // interval before debug output was enabled
+    GlDebug::Handler handler;
+
+    // inverse of the map functions, DontCare is the last value of each enum
+    template<typename T>
+    T fromGLenum(GLenum value, GLenum (*map)(T), T fallback)
+    {
+        for(int i=0; i<static_cast<int>(T::DontCare); ++i)
+        {
+            if(map(static_cast<T>(i)) == value)
+                return static_cast<T>(i);
+        }
+        return fallback;
+    }
+
+    void logMessage(const GlDebug::Message& message)
+    {
+#ifdef GLUE_LOGGING
+        const char* type = "";
+        switch(message.type)
+        {
+        case GlDebug::Type::Error: type = "error"; break;
+        case GlDebug::Type::DeprecatedBehavior: type = "deprecated behavior"; break;
+        case GlDebug::Type::UndefinedBehavior: type = "undefined behavior"; break;
+        case GlDebug::Type::Portability: type = "portability"; break;
+        case GlDebug::Type::Performance: type = "performance"; break;
+        default: type = "message"; break;
+        }
+
+        if(message.type == GlDebug::Type::Error || message.severity == GlDebug::Severity::High)
+            LOG(ERROR) << "GL " << type << " " << message.id << ": " << message.text;
+        else
+            LOG(WARNING) << "GL " << type << " " << message.id << ": " << message.text;
+#else
+        (void)message;
+#endif
+    }
+
+    void APIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* text, const void*)
+    {
+        GlDebug::Message message;
+        message.source = fromGLenum(source, mapDebugSource, GlDebug::Source::Other);
+        message.type = fromGLenum(type, mapDebugType, GlDebug::Type::Other);
+        message.severity = fromGLenum(severity, mapDebugSeverity, GlDebug::Severity::Notification);
+        message.id = id;
+        message.text = length >= 0 ? std::string(text, length) : std::string(text);
+
+        if(handler)
+            handler(message);
+        else
+            logMessage(message);
+    }
+}
+
+bool GlDebug::isAvailable()
+{
+    return GLAD_GL_KHR_debug != 0;
+}
+
+bool GlDebug::enableOutput(bool synchronous)
+{
+    if(!isAvailable())
+    {
+#ifdef GLUE_LOGGING
+        LOG(WARNING) << "Debug output is not supported (KHR_debug), falling back to glGetError";
+#endif
+        return false;
+    }
+
+#ifdef GLUE_LOGGING
+    GLint flags = 0;
+    GL_SAFE_CALL(glGetIntegerv(GL_CONTEXT_FLAGS, &flags));
+    if(!(flags & GL_CONTEXT_FLAG_DEBUG_BIT))
+        LOG(INFO) << "Debug output is enabled for a non-debug context, the driver may not report all messages";
+#endif
+
+    GL_SAFE_CALL(glDebugMessageCallback(debugCallback, nullptr));
+    GL_SAFE_CALL(glEnable(GL_DEBUG_OUTPUT));
+    if(synchronous)
+    {
+        GL_SAFE_CALL(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+    }
+    else
+    {
+        GL_SAFE_CALL(glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+    }
+
+    if(!outputEnabled)
+        savedErrorCheckInterval = glErrorCheckInterval;
+    outputEnabled = true;
+    glErrorCheckInterval = 0;
+    return true;
+}
+
+void GlDebug::disableOutput()
+{
+    if(!outputEnabled)
+        return;
+
+    GL_SAFE_CALL(glDisable(GL_DEBUG_OUTPUT));
+    GL_SAFE_CALL(glDebugMessageCallback(nullptr, nullptr));
+    outputEnabled = false;
+    glErrorCheckInterval = savedErrorCheckInterval;
+}
+
+bool GlDebug::isOutputEnabled()
+{
+    return outputEnabled;
+}
+
+void GlDebug::setHandler(Handler h)
+{
+    handler = h;
+}
+
+void GlDebug::setFilter(Source source, Type type, Severity severity, bool enabled)
+{
+    if(!isAvailable())
+        return;
+
+    GL_SAFE_CALL(glDebugMessageControl(mapDebugSource(source), mapDebugType(type), mapDebugSeverity(severity), 0, nullptr, enabled ? GL_TRUE : GL_FALSE));
+}
+
+void GlDebug::setMinimumSeverity(Severity severity)
+{
+    for(int i=0; i<static_cast<int>(Severity::DontCare); ++i)
+        setFilter(Source::DontCare, Type::DontCare, static_cast<Severity>(i), i <= static_cast<int>(severity));
+}
+
+void GlDebug::setErrorCheckInterval(unsigned int interval)
+{
+    glErrorCheckInterval = interval;
+}
+
+unsigned int GlDebug::errorCheckInterval()
+{
+    return glErrorCheckInterval;
+}
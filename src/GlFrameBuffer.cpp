@@ -2,41 +2,47 @@
 #include "glue/GlTexture1D.h"
 #include "glue/GlTexture2D.h"
 #include "glue/GlRenderBuffer.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 
 GlFrameBuffer::GlFrameBuffer()
 {
-    GL_SAFE_CALL(glGenFramebuffers(1, &_id));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glCreateFramebuffers(1, &_id));
+    }
+    else
+    {
+        GL_SAFE_CALL(glGenFramebuffers(1, &_id));
+    }
 }
 
 GlFrameBuffer::~GlFrameBuffer()
 {
     GL_SAFE_CALL(glDeleteFramebuffers(1, &_id));
+    GlState::current().frameBufferDeleted(_id);
 }
 
 void GlFrameBuffer::bind(Target target)
 {
-    GL_SAFE_CALL(glBindFramebuffer(mapFrameBufferTarget(target), _id));
+    GlState::current().bindFrameBuffer(target, _id);
 }
 
 
 void GlFrameBuffer::release(Target target)
 {
-    GL_SAFE_CALL(glBindFramebuffer(mapFrameBufferTarget(target), 0));
+    GlState::current().bindFrameBuffer(target, 0);
 }
 
 bool GlFrameBuffer::isBound() const
 {
-    int draw = -1, read = -1;
-    GL_SAFE_CALL(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw));
-    GL_SAFE_CALL(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read));
-    return draw == (int)_id || read == (int)_id;
+    return GlState::current().isFrameBufferBound(_id);
 }
 
 void GlFrameBuffer::attach(const GlTexture1D& texture, GlFrameBuffer::Attachment position, int level)
 {
 #ifdef GLUE_LOGGING
-    if(!isBound())
+    if(!useDirectStateAccess() && !isBound())
         LOG(WARNING) << "FrameBuffer is not bound!";
     if(position == Attachment::Depth && !texture.hasDepthFormat())
         LOG(WARNING) << "Attaching non-depth format to depth attachment";
@@ -44,7 +50,14 @@ void GlFrameBuffer::attach(const GlTexture1D& texture, GlFrameBuffer::Attachment
         LOG(WARNING) << "Attaching depth format to color attachment";
 #endif
 
-    GL_SAFE_CALL(glFramebufferTexture1D(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_TEXTURE_1D, texture.id(), level));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedFramebufferTexture(_id, mapFrameBufferAttachment(position), texture.id(), level));
+    }
+    else
+    {
+        GL_SAFE_CALL(glFramebufferTexture1D(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_TEXTURE_1D, texture.id(), level));
+    }
 
     if(position != Attachment::Depth && position != Attachment::Stencil)
     {
@@ -58,7 +71,7 @@ void GlFrameBuffer::attach(const GlTexture1D& texture, GlFrameBuffer::Attachment
 void GlFrameBuffer::attach(const GlTexture2D& texture, Attachment position, int level)
 {
 #ifdef GLUE_LOGGING
-    if(!isBound())
+    if(!useDirectStateAccess() && !isBound())
         LOG(WARNING) << "FrameBuffer is not bound!";
     if(position == Attachment::Depth && !texture.hasDepthFormat())
         LOG(WARNING) << "Attaching non-depth format to depth attachment";
@@ -66,7 +79,14 @@ void GlFrameBuffer::attach(const GlTexture2D& texture, Attachment position, int
         LOG(WARNING) << "Attaching depth format to color attachment";
 #endif
 
-    GL_SAFE_CALL(glFramebufferTexture2D(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_TEXTURE_2D, texture.id(), level));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedFramebufferTexture(_id, mapFrameBufferAttachment(position), texture.id(), level));
+    }
+    else
+    {
+        GL_SAFE_CALL(glFramebufferTexture2D(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_TEXTURE_2D, texture.id(), level));
+    }
 
     if(position != Attachment::Depth && position != Attachment::Stencil)
     {
@@ -79,14 +99,21 @@ void GlFrameBuffer::attach(const GlTexture2D& texture, Attachment position, int
 void GlFrameBuffer::attach(const GlRenderBuffer& renderbuffer, Attachment position)
 {
 #ifdef GLUE_LOGGING
-    if(!isBound())
+    if(!useDirectStateAccess() && !isBound())
         LOG(WARNING) << "FrameBuffer is not bound!";
     if(position == Attachment::Depth && !renderbuffer.hasDepthFormat())
         LOG(WARNING) << "Attaching non-depth format to depth attachment";
     else if(position != Attachment::Depth && renderbuffer.hasDepthFormat())
         LOG(WARNING) << "Attaching depth format to color attachment";
 #endif
-    GL_SAFE_CALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_RENDERBUFFER, renderbuffer.id()));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedFramebufferRenderbuffer(_id, mapFrameBufferAttachment(position), GL_RENDERBUFFER, renderbuffer.id()));
+    }
+    else
+    {
+        GL_SAFE_CALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_RENDERBUFFER, renderbuffer.id()));
+    }
 
     if(position != Attachment::Depth && position != Attachment::Stencil)
     {
@@ -99,11 +126,18 @@ void GlFrameBuffer::attach(const GlRenderBuffer& renderbuffer, Attachment positi
 void GlFrameBuffer::detach(Attachment position)
 {
 #ifdef GLUE_LOGGING
-    if(!isBound())
+    if(!useDirectStateAccess() && !isBound())
         LOG(DEBUG) << "FrameBuffer is not bound!";
 #endif
 
-    GL_SAFE_CALL(glFramebufferTexture2D(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_TEXTURE_2D, 0, 0));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedFramebufferTexture(_id, mapFrameBufferAttachment(position), 0, 0));
+    }
+    else
+    {
+        GL_SAFE_CALL(glFramebufferTexture2D(GL_FRAMEBUFFER, mapFrameBufferAttachment(position), GL_TEXTURE_2D, 0, 0));
+    }
 
     if(position != Attachment::Depth && position != Attachment::Stencil)
     {
@@ -125,19 +159,34 @@ void GlFrameBuffer::detach(Attachment position)
 void GlFrameBuffer::assignDrawBuffers()
 {
 #ifdef GLUE_LOGGING
-    if(!isBound()) LOG(DEBUG) << "FrameBuffer is not bound!";
+    if(!useDirectStateAccess() && !isBound()) LOG(DEBUG) << "FrameBuffer is not bound!";
 #endif
 
-    GL_SAFE_CALL(glDrawBuffers(_attachments.size(), &_attachments[0]));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedFramebufferDrawBuffers(_id, _attachments.size(), &_attachments[0]));
+    }
+    else
+    {
+        GL_SAFE_CALL(glDrawBuffers(_attachments.size(), &_attachments[0]));
+    }
 }
 
 bool GlFrameBuffer::isComplete(Target target) const
 {
 #ifdef GLUE_LOGGING
-    if(!isBound()) LOG(DEBUG) << "FrameBuffer is not bound!";
+    if(!useDirectStateAccess() && !isBound()) LOG(DEBUG) << "FrameBuffer is not bound!";
 #endif
 
-    GLenum completeness = GL_SAFE_CALL(glCheckFramebufferStatus(mapFrameBufferTarget(target)));
+    GLenum completeness = GL_NONE;
+    if(useDirectStateAccess())
+    {
+        completeness = GL_SAFE_CALL(glCheckNamedFramebufferStatus(_id, mapFrameBufferTarget(target)));
+    }
+    else
+    {
+        completeness = GL_SAFE_CALL(glCheckFramebufferStatus(mapFrameBufferTarget(target)));
+    }
     return completeness == GL_FRAMEBUFFER_COMPLETE;
 }
 
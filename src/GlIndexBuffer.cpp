@@ -1,35 +1,170 @@
 #include "glue/GlIndexBuffer.h"
 #include "glue/GlInternal.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GLUE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    void indexRange(const unsigned int* indices, size_t count, unsigned int& minIndex, unsigned int& maxIndex)
+    {
+        unsigned int low = std::numeric_limits<unsigned int>::max();
+        unsigned int high = 0;
+        size_t i = 0;
+#ifdef GLUE_SSE2
+        if(count >= 4)
+        {
+            // SSE2 only compares signed integers, flipping the sign bit maps the unsigned order to the signed order
+            const __m128i sign = _mm_set1_epi32(INT32_MIN);
+            __m128i vlow = _mm_set1_epi32(INT32_MAX);
+            __m128i vhigh = _mm_set1_epi32(INT32_MIN);
+            for(; i+4 <= count; i+=4)
+            {
+                __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), sign);
+                __m128i less = _mm_cmplt_epi32(v, vlow);
+                __m128i greater = _mm_cmpgt_epi32(v, vhigh);
+                vlow = _mm_or_si128(_mm_and_si128(less, v), _mm_andnot_si128(less, vlow));
+                vhigh = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, vhigh));
+            }
+            uint32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(vlow, sign));
+            low = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(vhigh, sign));
+            high = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        }
+#endif
+        for(; i<count; ++i)
+        {
+            low = std::min(low, indices[i]);
+            high = std::max(high, indices[i]);
+        }
+        minIndex = count > 0 ? low : 0;
+        maxIndex = high;
+    }
+
+    // all indices must be smaller than 2^16
+    void narrowToShort(const unsigned int* src, size_t count, uint16_t* dst)
+    {
+        size_t i = 0;
+#ifdef GLUE_SSE2
+        // there is no unsigned 32 to 16 bit pack in SSE2, so the values are shifted into the signed range and back
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16(INT16_MIN);
+        for(; i+8 <= count; i+=8)
+        {
+            __m128i a = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), bias32);
+            __m128i b = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)), bias32);
+            __m128i packed = _mm_xor_si128(_mm_packs_epi32(a, b), bias16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#endif
+        for(; i<count; ++i)
+            dst[i] = static_cast<uint16_t>(src[i]);
+    }
+
+    // all indices must be smaller than 2^8
+    void narrowToByte(const unsigned int* src, size_t count, uint8_t* dst)
+    {
+        size_t i = 0;
+#ifdef GLUE_SSE2
+        for(; i+16 <= count; i+=16)
+        {
+            const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+            __m128i low = _mm_packs_epi32(_mm_loadu_si128(s), _mm_loadu_si128(s + 1));
+            __m128i high = _mm_packs_epi32(_mm_loadu_si128(s + 2), _mm_loadu_si128(s + 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+        }
+#endif
+        for(; i<count; ++i)
+            dst[i] = static_cast<uint8_t>(src[i]);
+    }
+
+    void narrow(const unsigned int* src, size_t count, GlIndexBuffer::IndexType type, void* dst)
+    {
+        switch(type)
+        {
+        case GlIndexBuffer::UCHAR: narrowToByte(src, count, static_cast<uint8_t*>(dst)); break;
+        case GlIndexBuffer::USHORT: narrowToShort(src, count, static_cast<uint16_t*>(dst)); break;
+        case GlIndexBuffer::UINT: std::copy(src, src + count, static_cast<unsigned int*>(dst)); break;
+        }
+    }
+}
+
 GlIndexBuffer::GlIndexBuffer():
     GlBuffer(GlBuffer::Target::ElementArray),
     _numIndices(0),
-    _type(UCHAR)
+    _type(UCHAR),
+    _minIndex(0),
+    _maxIndex(0)
 {
 
 }
 
-void GlIndexBuffer::setData(GlBuffer::Usage usage, std::vector<unsigned char> i)
+void GlIndexBuffer::setData(GlBuffer::Usage usage, const std::vector<unsigned char>& i)
 {
-    GlBuffer::setData(usage, &i[0], i.size() * sizeof(unsigned char));
+    GlBuffer::setData(usage, i.data(), i.size() * sizeof(unsigned char));
     _numIndices = i.size();
     _type = UCHAR;
 }
 
-void GlIndexBuffer::setData(GlBuffer::Usage usage, std::vector<unsigned short> i)
+void GlIndexBuffer::setData(GlBuffer::Usage usage, const std::vector<unsigned short>& i)
 {
-    GlBuffer::setData(usage, &i[0], i.size() * sizeof(unsigned short));
+    GlBuffer::setData(usage, i.data(), i.size() * sizeof(unsigned short));
     _numIndices = i.size();
     _type = USHORT;
 }
 
-void GlIndexBuffer::setData(GlBuffer::Usage usage, std::vector<unsigned int> i)
+void GlIndexBuffer::setData(GlBuffer::Usage usage, const std::vector<unsigned int>& i)
 {
-    GlBuffer::setData(usage, &i[0], i.size() * sizeof(unsigned int));
+    GlBuffer::setData(usage, i.data(), i.size() * sizeof(unsigned int));
     _numIndices = i.size();
     _type = UINT;
 }
 
+GlIndexBuffer::IndexType GlIndexBuffer::setDataNarrowed(GlBuffer::Usage usage, GlUtils::array_view<unsigned int> i, bool allowUChar)
+{
+    indexRange(i.data(), i.size(), _minIndex, _maxIndex);
+
+    IndexType type = UINT;
+    if(allowUChar && _maxIndex <= std::numeric_limits<uint8_t>::max())
+        type = UCHAR;
+    else if(_maxIndex <= std::numeric_limits<uint16_t>::max())
+        type = USHORT;
+
+    _numIndices = i.size();
+    _type = type;
+
+    const size_t size = i.size() * indexSize(type);
+    if(type == UINT || size == 0)
+    {
+        GlBuffer::setData(usage, i.data(), size);
+        return type;
+    }
+
+    // convert directly into the new storage, no temporary copy is needed
+    GlBuffer::setData(usage, nullptr, size);
+    void* mapping = map(0, size, MapWrite | MapInvalidateBuffer);
+    if(mapping)
+    {
+        narrow(i.data(), i.size(), type, mapping);
+        if(unmap())
+            return type;
+    }
+
+    // the mapping failed or the content got corrupted while it was mapped
+    std::vector<unsigned int> converted((size + sizeof(unsigned int) - 1) / sizeof(unsigned int));
+    narrow(i.data(), i.size(), type, converted.data());
+    GlBuffer::setSubData(converted.data(), size, 0);
+    return type;
+}
+
 size_t GlIndexBuffer::numIndices() const
 {
     return _numIndices;
@@ -40,3 +175,24 @@ GlIndexBuffer::IndexType GlIndexBuffer::indexType() const
     return _type;
 }
 
+size_t GlIndexBuffer::indexSize(IndexType type)
+{
+    switch(type)
+    {
+    case UCHAR: return 1;
+    case USHORT: return 2;
+    case UINT: return 4;
+    }
+    assert(false);
+    return 0;
+}
+
+unsigned int GlIndexBuffer::minIndex() const
+{
+    return _minIndex;
+}
+
+unsigned int GlIndexBuffer::maxIndex() const
+{
+    return _maxIndex;
+}
@@ -0,0 +1,61 @@
+#include "glue/GlIndirectBuffer.h"
+#include "glue/GlInternal.h"
+
+GlIndirectBuffer::GlIndirectBuffer():
+    GlBuffer(GlBuffer::Target::DrawIndirect),
+    _numCommands(0)
+{
+
+}
+
+void GlIndirectBuffer::bind()
+{
+    if(GLAD_GL_ARB_draw_indirect)
+        GlBuffer::bind();
+}
+
+void GlIndirectBuffer::release()
+{
+    if(GLAD_GL_ARB_draw_indirect)
+        GlBuffer::release();
+}
+
+bool GlIndirectBuffer::isBound() const
+{
+    return GLAD_GL_ARB_draw_indirect ? GlBuffer::isBound() : true;
+}
+
+void GlIndirectBuffer::setData(GlBuffer::Usage usage, GlUtils::array_view<DrawArraysCommand> commands)
+{
+    setCommands(usage, commands.data(), commands.size() * sizeof(DrawArraysCommand), commands.size());
+}
+
+void GlIndirectBuffer::setData(GlBuffer::Usage usage, GlUtils::array_view<DrawElementsCommand> commands)
+{
+    setCommands(usage, commands.data(), commands.size() * sizeof(DrawElementsCommand), commands.size());
+}
+
+size_t GlIndirectBuffer::numCommands() const
+{
+    return _numCommands;
+}
+
+const void* GlIndirectBuffer::clientCommands() const
+{
+    return GLAD_GL_ARB_draw_indirect ? nullptr : _clientCommands.data();
+}
+
+void GlIndirectBuffer::setCommands(GlBuffer::Usage usage, const void* data, size_t size, size_t numCommands)
+{
+    if(GLAD_GL_ARB_draw_indirect)
+    {
+        GlBuffer::setData(usage, data, size);
+    }
+    else
+    {
+        // the draw indirect target does not exist, the commands are submitted from the CPU
+        const char* bytes = static_cast<const char*>(data);
+        _clientCommands.assign(bytes, bytes + size);
+    }
+    _numCommands = numCommands;
+}
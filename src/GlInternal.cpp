@@ -1,12 +1,22 @@
 #include "glue/GlInternal.h"
+#include "glue/GlState.h"
 #include <cassert>
 
+bool useDirectStateAccess()
+{
+    return GlState::current().directStateAccess();
+}
+
 GLenum mapBufferTarget(GlBuffer::Target value)
 {
     switch(value)
     {
     case GlBuffer::Target::Array: return GL_ARRAY_BUFFER;
     case GlBuffer::Target::ElementArray: return GL_ELEMENT_ARRAY_BUFFER;
+    case GlBuffer::Target::DrawIndirect: return GL_DRAW_INDIRECT_BUFFER;
+    case GlBuffer::Target::DispatchIndirect: return GL_DISPATCH_INDIRECT_BUFFER;
+    case GlBuffer::Target::ShaderStorage: return GL_SHADER_STORAGE_BUFFER;
+    case GlBuffer::Target::Uniform: return GL_UNIFORM_BUFFER;
     }
     assert(false);
     return GL_NONE;
@@ -30,6 +40,20 @@ GLenum mapBufferUsage(GlBuffer::Usage value)
     return GL_NONE;
 }
 
+GLbitfield mapBufferAccess(unsigned int value)
+{
+    GLbitfield access = 0;
+    if(value & GlBuffer::MapRead) access |= GL_MAP_READ_BIT;
+    if(value & GlBuffer::MapWrite) access |= GL_MAP_WRITE_BIT;
+    if(value & GlBuffer::MapInvalidateRange) access |= GL_MAP_INVALIDATE_RANGE_BIT;
+    if(value & GlBuffer::MapInvalidateBuffer) access |= GL_MAP_INVALIDATE_BUFFER_BIT;
+    if(value & GlBuffer::MapFlushExplicit) access |= GL_MAP_FLUSH_EXPLICIT_BIT;
+    if(value & GlBuffer::MapUnsynchronized) access |= GL_MAP_UNSYNCHRONIZED_BIT;
+    if(value & GlBuffer::MapPersistent) access |= GL_MAP_PERSISTENT_BIT;
+    if(value & GlBuffer::MapCoherent) access |= GL_MAP_COHERENT_BIT;
+    return access;
+}
+
 GLenum mapVertexAttributeType(GlVertexBuffer::VertexAttribute::Type value)
 {
     switch(value)
@@ -40,7 +64,10 @@ GLenum mapVertexAttributeType(GlVertexBuffer::VertexAttribute::Type value)
     case GlVertexBuffer::VertexAttribute::UnsignedShort: return GL_UNSIGNED_SHORT;
     case GlVertexBuffer::VertexAttribute::Int: return GL_INT;
     case GlVertexBuffer::VertexAttribute::UnsignedInt: return GL_UNSIGNED_INT;
+    case GlVertexBuffer::VertexAttribute::HalfFloat: return GL_HALF_FLOAT;
     case GlVertexBuffer::VertexAttribute::Float: return GL_FLOAT;
+    case GlVertexBuffer::VertexAttribute::Int2101010Rev: return GL_INT_2_10_10_10_REV;
+    case GlVertexBuffer::VertexAttribute::UnsignedInt2101010Rev: return GL_UNSIGNED_INT_2_10_10_10_REV;
     }
     assert(false);
     return GL_NONE;
@@ -185,6 +212,7 @@ GLenum mapShaderType(GlShader::Type value)
     case GlShader::Type::VertexShader: return GL_VERTEX_SHADER;
     case GlShader::Type::GeometryShader: return GL_GEOMETRY_SHADER;
     case GlShader::Type::FragmentShader: return GL_FRAGMENT_SHADER;
+    case GlShader::Type::ComputeShader: return GL_COMPUTE_SHADER;
     }
     assert(false);
     return GL_NONE;
@@ -225,3 +253,72 @@ GLenum mapQueryTarget(GlQuery::Target value)
     assert(false);
     return GL_NONE;
 }
+
+GLenum mapDebugSource(GlDebug::Source value)
+{
+    switch(value)
+    {
+    case GlDebug::Source::Api: return GL_DEBUG_SOURCE_API;
+    case GlDebug::Source::WindowSystem: return GL_DEBUG_SOURCE_WINDOW_SYSTEM;
+    case GlDebug::Source::ShaderCompiler: return GL_DEBUG_SOURCE_SHADER_COMPILER;
+    case GlDebug::Source::ThirdParty: return GL_DEBUG_SOURCE_THIRD_PARTY;
+    case GlDebug::Source::Application: return GL_DEBUG_SOURCE_APPLICATION;
+    case GlDebug::Source::Other: return GL_DEBUG_SOURCE_OTHER;
+    case GlDebug::Source::DontCare: return GL_DONT_CARE;
+    }
+    assert(false);
+    return GL_NONE;
+}
+
+GLenum mapDebugType(GlDebug::Type value)
+{
+    switch(value)
+    {
+    case GlDebug::Type::Error: return GL_DEBUG_TYPE_ERROR;
+    case GlDebug::Type::DeprecatedBehavior: return GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR;
+    case GlDebug::Type::UndefinedBehavior: return GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR;
+    case GlDebug::Type::Portability: return GL_DEBUG_TYPE_PORTABILITY;
+    case GlDebug::Type::Performance: return GL_DEBUG_TYPE_PERFORMANCE;
+    case GlDebug::Type::Marker: return GL_DEBUG_TYPE_MARKER;
+    case GlDebug::Type::PushGroup: return GL_DEBUG_TYPE_PUSH_GROUP;
+    case GlDebug::Type::PopGroup: return GL_DEBUG_TYPE_POP_GROUP;
+    case GlDebug::Type::Other: return GL_DEBUG_TYPE_OTHER;
+    case GlDebug::Type::DontCare: return GL_DONT_CARE;
+    }
+    assert(false);
+    return GL_NONE;
+}
+
+GLenum mapDebugSeverity(GlDebug::Severity value)
+{
+    switch(value)
+    {
+    case GlDebug::Severity::High: return GL_DEBUG_SEVERITY_HIGH;
+    case GlDebug::Severity::Medium: return GL_DEBUG_SEVERITY_MEDIUM;
+    case GlDebug::Severity::Low: return GL_DEBUG_SEVERITY_LOW;
+    case GlDebug::Severity::Notification: return GL_DEBUG_SEVERITY_NOTIFICATION;
+    case GlDebug::Severity::DontCare: return GL_DONT_CARE;
+    }
+    assert(false);
+    return GL_NONE;
+}
+
+GLbitfield mapMemoryBarrier(unsigned int value)
+{
+    if(value == GlMemoryBarrier::All)
+        return GL_ALL_BARRIER_BITS;
+
+    GLbitfield barriers = 0;
+    if(value & GlMemoryBarrier::VertexAttribArray) barriers |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+    if(value & GlMemoryBarrier::ElementArray) barriers |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+    if(value & GlMemoryBarrier::Uniform) barriers |= GL_UNIFORM_BARRIER_BIT;
+    if(value & GlMemoryBarrier::TextureFetch) barriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+    if(value & GlMemoryBarrier::ShaderImageAccess) barriers |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    if(value & GlMemoryBarrier::Command) barriers |= GL_COMMAND_BARRIER_BIT;
+    if(value & GlMemoryBarrier::PixelBuffer) barriers |= GL_PIXEL_BUFFER_BARRIER_BIT;
+    if(value & GlMemoryBarrier::TextureUpdate) barriers |= GL_TEXTURE_UPDATE_BARRIER_BIT;
+    if(value & GlMemoryBarrier::BufferUpdate) barriers |= GL_BUFFER_UPDATE_BARRIER_BIT;
+    if(value & GlMemoryBarrier::FrameBuffer) barriers |= GL_FRAMEBUFFER_BARRIER_BIT;
+    if(value & GlMemoryBarrier::ShaderStorage) barriers |= GL_SHADER_STORAGE_BARRIER_BIT;
+    return barriers;
+}
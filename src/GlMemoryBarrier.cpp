@@ -0,0 +1,15 @@
+#include "glue/GlMemoryBarrier.h"
+#include "glue/GlInternal.h"
+
+bool GlMemoryBarrier::isAvailable()
+{
+    return GLAD_GL_ARB_shader_image_load_store != 0;
+}
+
+void GlMemoryBarrier::insert(unsigned int bits)
+{
+    if(!isAvailable())
+        return;
+
+    GL_SAFE_CALL(glMemoryBarrier(mapMemoryBarrier(bits)));
+}
@@ -0,0 +1,299 @@
+#include "glue/GlMeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // parameters of the Forsyth algorithm
+    const unsigned int CacheSize = 32;
+    const float CacheDecayPower = 1.5f;
+    const float LastTriangleScore = 0.75f;
+    const float ValenceBoostScale = 2.0f;
+    const float ValenceBoostPower = 0.5f;
+
+    float vertexScore(int cachePosition, unsigned int remainingValence)
+    {
+        // vertices without remaining triangles are never needed again
+        if(remainingValence == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if(cachePosition >= 0)
+        {
+            // the vertices of the last triangle get a fixed score, so the next triangle does not simply reuse its edge
+            if(cachePosition < 3)
+                score = LastTriangleScore;
+            else
+                score = std::pow(1.0f - float(cachePosition - 3) / float(CacheSize - 3), CacheDecayPower);
+        }
+        // prefer vertices with few remaining triangles to avoid leaving lonely triangles behind
+        score += ValenceBoostScale * std::pow(float(remainingValence), -ValenceBoostPower);
+        return score;
+    }
+
+    struct Cluster
+    {
+        size_t begin;
+        size_t end;
+        float sortKey;
+    };
+}
+
+namespace GlUtils
+{
+    vertex_cache_stats analyze_vertex_cache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+    {
+        assert(indexCount % 3 == 0 && cacheSize > 0);
+
+        // a vertex is in the FIFO if it was transformed less than cacheSize transformations ago
+        std::vector<size_t> timestamps(vertexCount, 0);
+        size_t transformed = 0;
+        for(size_t i=0; i<indexCount; ++i)
+        {
+            const unsigned int v = indices[i];
+            assert(v < vertexCount);
+            if(timestamps[v] == 0 || transformed - timestamps[v] + 1 > cacheSize)
+            {
+                ++transformed;
+                timestamps[v] = transformed;
+            }
+        }
+
+        vertex_cache_stats stats;
+        stats.transformed = transformed;
+        stats.acmr = indexCount > 0 ? float(transformed) / float(indexCount / 3) : 0.0f;
+        stats.atvr = vertexCount > 0 ? float(transformed) / float(vertexCount) : 0.0f;
+        return stats;
+    }
+
+    void optimize_vertex_cache(unsigned int* indices, size_t indexCount, size_t vertexCount)
+    {
+        assert(indexCount % 3 == 0);
+
+        const size_t numTriangles = indexCount / 3;
+        const std::vector<unsigned int> source(indices, indices + indexCount);
+
+        // triangles adjacent to each vertex, the first remaining[v] entries are not emitted yet
+        std::vector<unsigned int> remaining(vertexCount, 0);
+        for(size_t i=0; i<indexCount; ++i)
+        {
+            assert(source[i] < vertexCount);
+            ++remaining[source[i]];
+        }
+        std::vector<unsigned int> offsets(vertexCount + 1, 0);
+        for(size_t v=0; v<vertexCount; ++v)
+            offsets[v+1] = offsets[v] + remaining[v];
+        std::vector<unsigned int> adjacency(indexCount);
+        {
+            std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+            for(size_t i=0; i<indexCount; ++i)
+                adjacency[fill[source[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        std::vector<float> scores(vertexCount);
+        for(size_t v=0; v<vertexCount; ++v)
+            scores[v] = vertexScore(-1, remaining[v]);
+
+        auto triangleScore = [&](size_t t)
+        {
+            return scores[source[3*t]] + scores[source[3*t+1]] + scores[source[3*t+2]];
+        };
+
+        std::vector<bool> emitted(numTriangles, false);
+        std::vector<unsigned int> cache, newCache;
+        cache.reserve(CacheSize + 3);
+        newCache.reserve(CacheSize + 3);
+
+        // start with the best triangle of the cold cache
+        long best = -1;
+        float bestScore = -1.0f;
+        for(size_t t=0; t<numTriangles; ++t)
+        {
+            const float score = triangleScore(t);
+            if(score > bestScore)
+            {
+                best = static_cast<long>(t);
+                bestScore = score;
+            }
+        }
+
+        size_t cursor = 0;
+        for(size_t out=0; out<numTriangles; ++out)
+        {
+            if(best < 0)
+            {
+                // no triangle is adjacent to the cache, continue with the next remaining one
+                while(emitted[cursor])
+                    ++cursor;
+                best = static_cast<long>(cursor);
+            }
+
+            const size_t t = static_cast<size_t>(best);
+            emitted[t] = true;
+            newCache.clear();
+            for(int k=0; k<3; ++k)
+            {
+                const unsigned int v = source[3*t+k];
+                indices[3*out+k] = v;
+
+                // remove the triangle from the remaining adjacency of the vertex
+                unsigned int* begin = &adjacency[offsets[v]];
+                unsigned int* end = begin + remaining[v];
+                unsigned int* it = std::find(begin, end, static_cast<unsigned int>(t));
+                assert(it != end);
+                std::swap(*it, *(end - 1));
+                --remaining[v];
+
+                if(std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                    newCache.push_back(v);
+            }
+
+            // the vertices of the triangle move to the front of the cache
+            const size_t numTriangleVertices = newCache.size();
+            for(auto v: cache)
+            {
+                if(std::find(newCache.begin(), newCache.begin() + numTriangleVertices, v) == newCache.begin() + numTriangleVertices)
+                    newCache.push_back(v);
+            }
+            // evicted vertices
+            for(size_t i=CacheSize; i<newCache.size(); ++i)
+                scores[newCache[i]] = vertexScore(-1, remaining[newCache[i]]);
+            if(newCache.size() > CacheSize)
+                newCache.resize(CacheSize);
+            cache.swap(newCache);
+
+            for(size_t i=0; i<cache.size(); ++i)
+                scores[cache[i]] = vertexScore(static_cast<int>(i), remaining[cache[i]]);
+
+            // the next triangle is the best one adjacent to the cache
+            best = -1;
+            bestScore = -1.0f;
+            for(auto v: cache)
+            {
+                for(unsigned int a=0; a<remaining[v]; ++a)
+                {
+                    const unsigned int candidate = adjacency[offsets[v] + a];
+                    const float score = triangleScore(candidate);
+                    if(score > bestScore)
+                    {
+                        best = static_cast<long>(candidate);
+                        bestScore = score;
+                    }
+                }
+            }
+        }
+    }
+
+    void optimize_overdraw(unsigned int* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride)
+    {
+        assert(indexCount % 3 == 0);
+
+        auto position = [&](unsigned int v)
+        {
+            assert(v < vertexCount);
+            return reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + v * positionStride);
+        };
+
+        // split into clusters where the simulated cache misses all vertices of a triangle
+        std::vector<Cluster> clusters;
+        {
+            const unsigned int cacheSize = 16;
+            std::vector<size_t> timestamps(vertexCount, 0);
+            size_t transformed = 0;
+            for(size_t i=0; i<indexCount; i+=3)
+            {
+                unsigned int misses = 0;
+                for(int k=0; k<3; ++k)
+                {
+                    const unsigned int v = indices[i+k];
+                    if(timestamps[v] == 0 || transformed - timestamps[v] + 1 > cacheSize)
+                    {
+                        ++transformed;
+                        timestamps[v] = transformed;
+                        ++misses;
+                    }
+                }
+                if(i == 0 || misses == 3)
+                {
+                    Cluster cluster = {i, i, 0.0f};
+                    clusters.push_back(cluster);
+                }
+                clusters.back().end = i + 3;
+            }
+        }
+        if(clusters.size() < 2)
+            return;
+
+        // area weighted centroid of the mesh
+        float meshCenter[3] = {0.0f, 0.0f, 0.0f};
+        float meshArea = 0.0f;
+        std::vector<float> clusterData(clusters.size() * 6, 0.0f);
+        for(size_t c=0; c<clusters.size(); ++c)
+        {
+            float* center = &clusterData[6*c];
+            float* normal = &clusterData[6*c+3];
+            float clusterArea = 0.0f;
+            for(size_t i=clusters[c].begin; i<clusters[c].end; i+=3)
+            {
+                const float* p0 = position(indices[i]);
+                const float* p1 = position(indices[i+1]);
+                const float* p2 = position(indices[i+2]);
+                const float e1[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+                const float e2[3] = {p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
+                // the length of the cross product is twice the area of the triangle
+                const float n[3] = {e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0]};
+                const float area = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+                for(int k=0; k<3; ++k)
+                {
+                    const float centroid = (p0[k] + p1[k] + p2[k]) / 3.0f;
+                    center[k] += centroid * area;
+                    meshCenter[k] += centroid * area;
+                    normal[k] += n[k];
+                }
+                clusterArea += area;
+            }
+            meshArea += clusterArea;
+            for(int k=0; k<3; ++k)
+                center[k] = clusterArea > 0.0f ? center[k] / clusterArea : 0.0f;
+        }
+        for(int k=0; k<3; ++k)
+            meshCenter[k] = meshArea > 0.0f ? meshCenter[k] / meshArea : 0.0f;
+
+        for(size_t c=0; c<clusters.size(); ++c)
+        {
+            const float* center = &clusterData[6*c];
+            const float* normal = &clusterData[6*c+3];
+            const float length = std::sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+            float key = 0.0f;
+            for(int k=0; k<3; ++k)
+                key += (center[k] - meshCenter[k]) * normal[k];
+            clusters[c].sortKey = length > 0.0f ? key / length : 0.0f;
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+        const std::vector<unsigned int> source(indices, indices + indexCount);
+        size_t out = 0;
+        for(const auto& cluster: clusters)
+        {
+            std::copy(source.begin() + cluster.begin, source.begin() + cluster.end, indices + out);
+            out += cluster.end - cluster.begin;
+        }
+    }
+
+    size_t optimize_vertex_fetch(unsigned int* indices, size_t indexCount, size_t vertexCount, std::vector<unsigned int>& remap)
+    {
+        remap.assign(vertexCount, unused_vertex);
+        unsigned int next = 0;
+        for(size_t i=0; i<indexCount; ++i)
+        {
+            unsigned int& v = indices[i];
+            assert(v < vertexCount);
+            if(remap[v] == unused_vertex)
+                remap[v] = next++;
+            v = remap[v];
+        }
+        return next;
+    }
+}
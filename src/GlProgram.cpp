@@ -1,9 +1,54 @@
 #include "glue/GlProgram.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 #include <glm/gtc/type_ptr.hpp>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+
+namespace
+{
+    const unsigned int InvalidIndex = 0xffffffff;
+
+    // size in bytes of one element of a uniform of the given type as passed to glUniform, 0 for unknown types
+    size_t uniformTypeSize(GLenum type)
+    {
+        switch(type)
+        {
+        case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL:
+            return 4;
+        case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2:
+            return 8;
+        case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+            return 12;
+        case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: case GL_FLOAT_MAT2:
+            return 16;
+        case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2:
+            return 24;
+        case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2:
+            return 32;
+        case GL_FLOAT_MAT3:
+            return 36;
+        case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3:
+            return 48;
+        case GL_FLOAT_MAT4:
+            return 64;
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW: case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_RECT: case GL_INT_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE: case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D: case GL_UNSIGNED_INT_SAMPLER_CUBE:
+        case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_RECT: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+            return 4;
+        }
+        return 0;
+    }
+}
 
 GlProgram::GlProgram(const std::string& vs, const std::string& fs):
 	GlProgram(std::make_shared<GlVertexShader>(vs), nullptr, std::make_shared<GlFragmentShader>(fs))
@@ -24,52 +69,155 @@ GlProgram::GlProgram(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlFragm
 }
 
 GlProgram::GlProgram(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlGeometryShader> gs, std::shared_ptr<GlFragmentShader> fs):
+	GlProgram(vs, gs, fs, nullptr, true)
+{
+
+}
+
+GlProgram::GlProgram(const std::string& cs):
+	GlProgram(std::make_shared<GlComputeShader>(cs))
+{
+
+}
+
+GlProgram::GlProgram(std::shared_ptr<GlComputeShader> cs):
+	GlProgram(nullptr, nullptr, nullptr, cs, true)
+{
+
+}
+
+GlProgram::GlProgram(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlGeometryShader> gs, std::shared_ptr<GlFragmentShader> fs,
+                     std::shared_ptr<GlComputeShader> cs, bool build):
 	_id(0),
 	_vs(vs),
 	_gs(gs),
-	_fs(fs)
+	_fs(fs),
+	_cs(cs),
+	_pending(false),
+	_linked(false)
 {
-	assert(_vs && _fs);
+	assert((_vs && _fs && !_cs) || (_cs && !_vs && !_gs && !_fs));
+    resetUniformStatistics();
+    _workGroupSize.fill(0);
 
-	if(!_vs->isValid())
+	_id = GL_SAFE_CALL(glCreateProgram());
+
+	if(_vs)
 	{
-		_vs->compile();
+		GL_SAFE_CALL(glAttachShader(_id, _vs->_id));
 	}
-
-	if(_gs && !_gs->isValid())
+	if(_gs)
 	{
-		_gs->compile();
+		GL_SAFE_CALL(glAttachShader(_id, _gs->_id));
 	}
-
-	if(!_fs->isValid())
+	if(_fs)
 	{
-		_fs->compile();
+		GL_SAFE_CALL(glAttachShader(_id, _fs->_id));
+	}
+	if(_cs)
+	{
+		GL_SAFE_CALL(glAttachShader(_id, _cs->_id));
 	}
 
-	_id = GL_SAFE_CALL(glCreateProgram());
+    if(build)
+    {
+        // the program is created before the stages are compiled, so it must not outlive a failed build
+        try
+        {
+            startBuild(false);
+            finish();
+        }
+        catch(...)
+        {
+            GL_SAFE_CALL(glDeleteProgram(_id));
+            throw;
+        }
+    }
+}
 
-	GL_SAFE_CALL(glAttachShader(_id, _vs->_id));
-	if(_gs)
-		GL_SAFE_CALL(glAttachShader(_id, _gs->_id));
-	GL_SAFE_CALL(glAttachShader(_id, _fs->_id));
+void GlProgram::startBuild(bool retrievable)
+{
+    // no status is queried here, so the driver can compile all stages and link in parallel
+    if(_vs)
+        _vs->submit();
+    if(_gs)
+        _gs->submit();
+    if(_fs)
+        _fs->submit();
+    if(_cs)
+        _cs->submit();
+
+    // must be set before linking, otherwise the driver may not keep the binary
+    if(retrievable && GLAD_GL_ARB_get_program_binary)
+    {
+        GL_SAFE_CALL(glProgramParameteri(_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
+	GL_SAFE_CALL(glLinkProgram(_id));
+    _pending = true;
+}
+
+bool GlProgram::checkLink()
+{
+	GLint isLinked;
+	GL_SAFE_CALL(glGetProgramiv(_id, GL_LINK_STATUS, &isLinked));
+    _linked = isLinked == GL_TRUE;
+
+#ifdef GLUE_LOGGING
+    if(!_linked)
+        LOG(ERROR) << "Program linking failed: " << linkLog();
+#endif
+    reflectUniforms();
+    reflectUniformBlocks();
+    reflectWorkGroupSize();
+    return _linked;
+}
+
+bool GlProgram::loadBinary(unsigned int format, const void* data, size_t size)
+{
+    if(!GLAD_GL_ARB_get_program_binary)
+        return false;
+
+    GL_SAFE_CALL(glProgramBinary(_id, format, data, static_cast<GLsizei>(size)));
+    GLint isLinked = GL_FALSE;
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_LINK_STATUS, &isLinked));
+    // the driver rejects binaries of other drivers or driver versions
+    if(isLinked != GL_TRUE)
+        return false;
+
+    _pending = false;
+    _linked = true;
+    reflectUniforms();
+    reflectUniformBlocks();
+    reflectWorkGroupSize();
+    return true;
+}
+
+bool GlProgram::binary(unsigned int& format, std::vector<char>& data) const
+{
+    if(!GLAD_GL_ARB_get_program_binary)
+        return false;
+
+    GLint length = 0;
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if(length <= 0)
+        return false;
 
-    link();
+    data.resize(length);
+    GLenum binaryFormat = GL_NONE;
+    GLsizei written = 0;
+    GL_SAFE_CALL(glGetProgramBinary(_id, length, &written, &binaryFormat, data.data()));
+    data.resize(written);
+    format = binaryFormat;
+    return written > 0;
 }
 
 std::string GlProgram::loadFile(const std::string &filepath)
 {
-    std::ifstream file(filepath);
-    if(file.is_open())
-    {
-        std::stringstream sstream;
-        sstream << file.rdbuf();
-        return sstream.str();
-    }
-    else
-    {
+    std::string source;
+    if(!GlUtils::read_file(filepath, source))
         throw std::runtime_error("Could not open " + filepath);
-    }
-    return "";
+    return source;
 }
 
 GlProgram *GlProgram::fromFile(const std::string &vs, const std::string &fs)
@@ -87,6 +235,66 @@ GlProgram *GlProgram::fromFile(const std::string &vs, const std::string &gs, con
     return new GlProgram(vsSrc, gsSrc, fsSrc);
 }
 
+GlProgram *GlProgram::fromFile(const std::string &cs)
+{
+    std::string csSrc = loadFile(cs);
+    return new GlProgram(csSrc);
+}
+
+GlProgram* GlProgram::submit(const std::string& vs, const std::string& fs)
+{
+    return submit(std::make_shared<GlVertexShader>(vs), nullptr, std::make_shared<GlFragmentShader>(fs));
+}
+
+GlProgram* GlProgram::submit(const std::string& vs, const std::string& gs, const std::string& fs)
+{
+    return submit(std::make_shared<GlVertexShader>(vs), std::make_shared<GlGeometryShader>(gs), std::make_shared<GlFragmentShader>(fs));
+}
+
+GlProgram* GlProgram::submit(std::shared_ptr<GlVertexShader> vs, std::shared_ptr<GlGeometryShader> gs, std::shared_ptr<GlFragmentShader> fs)
+{
+    GlProgram* program = new GlProgram(vs, gs, fs, nullptr, false);
+    program->startBuild(false);
+    return program;
+}
+
+GlProgram* GlProgram::submit(std::shared_ptr<GlComputeShader> cs)
+{
+    GlProgram* program = new GlProgram(nullptr, nullptr, nullptr, cs, false);
+    program->startBuild(false);
+    return program;
+}
+
+bool GlProgram::isReady() const
+{
+    if(!_pending || !GlShader::isParallelCompileAvailable())
+        return true;
+
+    // KHR and ARB use the same value
+    GLint completed = GL_TRUE;
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_COMPLETION_STATUS_KHR, &completed));
+    return completed == GL_TRUE;
+}
+
+bool GlProgram::finish()
+{
+    if(!_pending)
+        return _linked;
+
+    _pending = false;
+    if(!checkLink())
+    {
+        // report compile errors like the blocking constructors
+        const GlShader* shaders[] = {_vs.get(), _gs.get(), _fs.get(), _cs.get()};
+        for(auto shader: shaders)
+        {
+            if(shader && !shader->isValid())
+                throw GlShader::compile_exception(shader->compileLog());
+        }
+    }
+    return _linked;
+}
+
 std::shared_ptr<GlVertexShader> GlProgram::vertexShader() const
 {
 	return _vs;
@@ -102,16 +310,16 @@ std::shared_ptr<GlFragmentShader> GlProgram::fragmentShader() const
 	return _fs;
 }
 
-bool GlProgram::link()
+std::shared_ptr<GlComputeShader> GlProgram::computeShader() const
 {
-	GL_SAFE_CALL(glLinkProgram(_id));
-	GLint isLinked;
-	GL_SAFE_CALL(glGetProgramiv(_id, GL_LINK_STATUS, &isLinked));
+    return _cs;
+}
 
-#ifdef GLUE_LOGGING
-    LOG(INFO) << "Program linked: " << linkLog();
-#endif
-    return isLinked == GL_TRUE;
+bool GlProgram::link()
+{
+    // shaders of programs restored from a binary were never compiled
+    startBuild(false);
+    return finish();
 }
 
 std::string GlProgram::linkLog() const
@@ -132,12 +340,59 @@ std::string GlProgram::linkLog() const
 
 void GlProgram::activate()
 {
-	GL_SAFE_CALL(glUseProgram(_id));
+    if(_pending)
+        finish();
+    GlState::current().useProgram(_id);
 }
 
 void GlProgram::deactivate()
 {
-	GL_SAFE_CALL(glUseProgram(0));
+    GlState::current().useProgram(0);
+}
+
+std::array<unsigned int, 3> GlProgram::workGroupSize() const
+{
+    return _workGroupSize;
+}
+
+void GlProgram::dispatch(unsigned int x, unsigned int y, unsigned int z)
+{
+    assert(_cs);
+    activate();
+    GL_SAFE_CALL(glDispatchCompute(x, y, z));
+}
+
+void GlProgram::dispatchInvocations(unsigned int x, unsigned int y, unsigned int z)
+{
+    // the work group size is only known once the program is linked
+    if(_pending)
+        finish();
+
+    const unsigned int invocations[] = {x, y, z};
+    unsigned int groups[3];
+    for(int i=0; i<3; ++i)
+        groups[i] = _workGroupSize[i] > 0 ? (invocations[i] + _workGroupSize[i] - 1) / _workGroupSize[i] : 0;
+    dispatch(groups[0], groups[1], groups[2]);
+}
+
+void GlProgram::dispatchIndirect(GlBuffer& buffer, size_t offset)
+{
+    assert(_cs && buffer.target() == GlBuffer::Target::DispatchIndirect);
+    activate();
+    buffer.bind();
+    GL_SAFE_CALL(glDispatchComputeIndirect(static_cast<GLintptr>(offset)));
+}
+
+void GlProgram::reflectWorkGroupSize()
+{
+    _workGroupSize.fill(0);
+    if(!_cs || !_linked)
+        return;
+
+    GLint size[3] = {0, 0, 0};
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_COMPUTE_WORK_GROUP_SIZE, size));
+    for(int i=0; i<3; ++i)
+        _workGroupSize[i] = static_cast<unsigned int>(size[i]);
 }
 
 void GlProgram::setFragDataLocation(const std::string& name, int colorNumber)
@@ -153,116 +408,719 @@ int GlProgram::getAttributeLocation(const std::string& name)
 
 int GlProgram::getUniformLocation(const std::string& name)
 {
+    UniformHandle handle = uniform(name);
+    if(handle.isValid())
+        return _uniforms[handle.index].location;
+
+    // only the first element of arrays is in the table
+    if(name.find('[') == std::string::npos)
+        return -1;
     GLint location = GL_SAFE_CALL(glGetUniformLocation(_id, name.c_str()));
     return location;
 }
 
-#ifdef GLUE_GLM
-void GlProgram::setUniform(const std::string &name, const glm::mat4 &value)
+const std::vector<GlProgram::UniformInfo>& GlProgram::uniforms() const
+{
+    return _uniforms;
+}
+
+GlProgram::UniformHandle GlProgram::uniform(const std::string& name) const
+{
+    UniformHandle handle = uniform(GlUtils::hash_string(name));
+    // reject hash collisions with names that are not uniforms
+    if(handle.isValid())
+    {
+        const std::string& uniformName = _uniforms[handle.index].name;
+        if(name != uniformName && name != uniformName + "[0]")
+        {
+            handle.index = InvalidIndex;
+            handle.location = -1;
+        }
+    }
+    return handle;
+}
+
+GlProgram::UniformHandle GlProgram::uniform(uint32_t nameHash) const
+{
+    UniformHandle handle;
+    handle.index = findUniform(nameHash);
+    handle.location = handle.index != InvalidIndex ? _uniforms[handle.index].location : -1;
+    return handle;
+}
+
+const GlProgram::UniformInfo& GlProgram::uniformInfo(UniformHandle uniform) const
 {
-    int location = getUniformLocation(name);
+    assert(uniform.index < _uniforms.size());
+    return _uniforms[uniform.index];
+}
+
+const std::vector<GlProgram::UniformBlockInfo>& GlProgram::uniformBlocks() const
+{
+    return _uniformBlocks;
+}
+
+int GlProgram::uniformBlockIndex(const std::string& name) const
+{
+    for(const auto& block: _uniformBlocks)
+    {
+        if(block.name == name)
+            return static_cast<int>(block.index);
+    }
+    return -1;
+}
+
+void GlProgram::setUniformBlockBinding(const std::string& name, unsigned int binding)
+{
+    const int index = uniformBlockIndex(name);
+    if(index < 0)
+    {
 #ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+        LOG(WARNING) << "Uniform block " << name << " not found";
 #endif
-    GL_SAFE_CALL(glUniformMatrix4fv(location, 1, false, glm::value_ptr(value)));
+        return;
+    }
+    setUniformBlockBinding(static_cast<unsigned int>(index), binding);
 }
 
-void GlProgram::setUniform(const std::string& name, const glm::vec3& value)
+void GlProgram::setUniformBlockBinding(unsigned int blockIndex, unsigned int binding)
+{
+    assert(blockIndex < _uniformBlocks.size());
+    UniformBlockInfo& block = _uniformBlocks[blockIndex];
+    if(block.binding == binding)
+        return;
+
+    GL_SAFE_CALL(glUniformBlockBinding(_id, blockIndex, binding));
+    block.binding = binding;
+}
+
+void GlProgram::reflectUniformBlocks()
+{
+    _uniformBlocks.clear();
+    if(!_linked)
+        return;
+
+    GLint numBlocks = 0, maxLength = 0;
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_ACTIVE_UNIFORM_BLOCKS, &numBlocks));
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength));
+
+    // block indices are consecutive, so the index is also the position in _uniformBlocks
+    std::vector<GLchar> name(std::max(maxLength, 1));
+    for(GLint i=0; i<numBlocks; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0, binding = 0;
+        GL_SAFE_CALL(glGetActiveUniformBlockName(_id, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, name.data()));
+        GL_SAFE_CALL(glGetActiveUniformBlockiv(_id, static_cast<GLuint>(i), GL_UNIFORM_BLOCK_DATA_SIZE, &size));
+        GL_SAFE_CALL(glGetActiveUniformBlockiv(_id, static_cast<GLuint>(i), GL_UNIFORM_BLOCK_BINDING, &binding));
+
+        UniformBlockInfo info;
+        info.name.assign(name.data(), length);
+        info.index = static_cast<unsigned int>(i);
+        info.size = static_cast<size_t>(size);
+        info.binding = static_cast<unsigned int>(binding);
+        _uniformBlocks.push_back(info);
+    }
+}
+
+void GlProgram::reflectUniforms()
+{
+    _uniforms.clear();
+    _uniformTable.clear();
+    _uniformSlots.clear();
+    _uniformValues.clear();
+    _uniformKnown.clear();
+
+    GLint isLinked = GL_FALSE;
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_LINK_STATUS, &isLinked));
+    if(isLinked != GL_TRUE)
+        return;
+
+    GLint numUniforms = 0, maxLength = 0;
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_ACTIVE_UNIFORMS, &numUniforms));
+    GL_SAFE_CALL(glGetProgramiv(_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+    std::vector<GLchar> name(std::max(maxLength, 1));
+    std::vector<bool> isArray(numUniforms, false);
+    for(GLint i=0; i<numUniforms; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = GL_NONE;
+        GL_SAFE_CALL(glGetActiveUniform(_id, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &size, &type, name.data()));
+
+        UniformInfo info;
+        info.name.assign(name.data(), length);
+        info.type = type;
+        info.size = size;
+        info.location = GL_SAFE_CALL(glGetUniformLocation(_id, info.name.c_str()));
+        const size_t subscript = info.name.size() >= 3 ? info.name.size() - 3 : std::string::npos;
+        if(subscript != std::string::npos && info.name.compare(subscript, 3, "[0]") == 0)
+        {
+            info.name.erase(subscript);
+            isArray[i] = true;
+        }
+        _uniforms.push_back(info);
+    }
+
+    // at most half of the table is used, so probe sequences stay short
+    size_t tableSize = 1;
+    while(tableSize < 4 * _uniforms.size())
+        tableSize *= 2;
+    _uniformTable.assign(tableSize, std::make_pair(0u, InvalidIndex));
+    for(unsigned int i=0; i<_uniforms.size(); ++i)
+    {
+        insertUniform(GlUtils::hash_string(_uniforms[i].name), i);
+        if(isArray[i])
+            insertUniform(GlUtils::hash_string(_uniforms[i].name + "[0]"), i);
+    }
+
+    // shadow storage of the uniform values, the elements of an array are stored consecutively
+    // so array updates starting at any element can be compared at once
+    for(unsigned int i=0; i<_uniforms.size(); ++i)
+    {
+        const UniformInfo& info = _uniforms[i];
+        const size_t elementSize = uniformTypeSize(info.type);
+        if(info.location < 0 || elementSize == 0)
+            continue;
+
+        const uint32_t begin = static_cast<uint32_t>(_uniformValues.size());
+        const uint32_t end = begin + static_cast<uint32_t>(elementSize * info.size);
+        for(int e=0; e<info.size; ++e)
+        {
+            GLint location = info.location;
+            if(e > 0)
+            {
+                const std::string element = info.name + "[" + std::to_string(e) + "]";
+                location = GL_SAFE_CALL(glGetUniformLocation(_id, element.c_str()));
+            }
+            if(location < 0)
+                continue;
+            if(static_cast<size_t>(location) >= _uniformSlots.size())
+                _uniformSlots.resize(location + 1, std::make_pair(0u, 0u));
+            const uint32_t offset = begin + static_cast<uint32_t>(elementSize * e);
+            _uniformSlots[location] = std::make_pair(offset, end - offset);
+        }
+        _uniformValues.resize(end, 0);
+    }
+    // values are unknown until written, uniforms may have initializers in the shader
+    _uniformKnown.assign(_uniformValues.size(), 0);
+}
+
+void GlProgram::insertUniform(uint32_t hash, unsigned int index)
 {
-    int location = getUniformLocation(name);
+    const size_t mask = _uniformTable.size() - 1;
+    for(size_t slot=hash & mask; ; slot=(slot + 1) & mask)
+    {
+        auto& entry = _uniformTable[slot];
+        if(entry.second == InvalidIndex)
+        {
+            entry.first = hash;
+            entry.second = index;
+            return;
+        }
+        if(entry.first == hash)
+        {
 #ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+            if(entry.second != index)
+                LOG(WARNING) << "Uniforms " << _uniforms[entry.second].name << " and " << _uniforms[index].name << " have the same hash";
 #endif
-    GL_SAFE_CALL(glUniform3fv(location, 3, glm::value_ptr(value)));
+            return;
+        }
+    }
+}
+
+unsigned int GlProgram::findUniform(uint32_t hash) const
+{
+    if(_uniformTable.empty())
+        return InvalidIndex;
+
+    const size_t mask = _uniformTable.size() - 1;
+    for(size_t slot=hash & mask; ; slot=(slot + 1) & mask)
+    {
+        const auto& entry = _uniformTable[slot];
+        if(entry.second == InvalidIndex)
+            return InvalidIndex;
+        if(entry.first == hash)
+            return entry.second;
+    }
+}
+
+GlProgram::UniformStatistics GlProgram::uniformStatistics() const
+{
+    return _uniformStatistics;
 }
-#endif
 
-void GlProgram::setUniform(const std::__cxx11::string& name, const QColor& value)
+void GlProgram::resetUniformStatistics()
 {
-    int location = getUniformLocation(name);
+    _uniformStatistics.issued = 0;
+    _uniformStatistics.skipped = 0;
+}
+
+void GlProgram::invalidateUniformCache()
+{
+    std::fill(_uniformKnown.begin(), _uniformKnown.end(), 0);
+}
+
+GlProgram::UniformHandle GlProgram::namedUniform(const std::string& name)
+{
+    UniformHandle handle = uniform(name);
+    if(!handle.isValid())
+    {
+        handle.location = getUniformLocation(name);
 #ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+        if(handle.location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
 #endif
-    GL_SAFE_CALL(glUniform4f(location,
-                             static_cast<float>(value.redF()),
-                             static_cast<float>(value.greenF()),
-                             static_cast<float>(value.blueF()),
-                             static_cast<float>(value.alphaF())));
+    }
+    return handle;
+}
+
+bool GlProgram::updateUniform(int location, const void* data, size_t size)
+{
+    // setting location -1 is silently ignored by the GL
+    if(location < 0)
+        return false;
+
+    if(static_cast<size_t>(location) >= _uniformSlots.size())
+    {
+        // no shadow storage for this location or type
+        ++_uniformStatistics.issued;
+        return true;
+    }
+
+    if(size > _uniformSlots[location].second)
+    {
+        // the GL still writes the elements that fit, so their shadow values are unknown now
+        if(_uniformSlots[location].second > 0)
+            std::memset(&_uniformKnown[_uniformSlots[location].first], 0, _uniformSlots[location].second);
+        ++_uniformStatistics.issued;
+        return true;
+    }
+
+    const uint32_t offset = _uniformSlots[location].first;
+    unsigned char* value = &_uniformValues[offset];
+    unsigned char* known = &_uniformKnown[offset];
+    if(std::memchr(known, 0, size) == nullptr && std::memcmp(value, data, size) == 0)
+    {
+        ++_uniformStatistics.skipped;
+        return false;
+    }
+
+    std::memcpy(value, data, size);
+    std::memset(known, 1, size);
+    ++_uniformStatistics.issued;
+    return true;
+}
+
+#ifdef GLUE_GLM
+void GlProgram::setUniform(const std::string& name, const glm::mat4& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::vec3& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::vec2& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::vec4& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::mat3& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::ivec2& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::ivec3& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const glm::ivec4& value)
+{
+    setUniform(namedUniform(name), value);
 }
+#endif
 
 #ifdef GLUE_QT
+void GlProgram::setUniform(const std::string& name, const QColor& value)
+{
+    setUniform(namedUniform(name), value);
+}
+
 void GlProgram::setUniform(const std::string& name, const QVector2D& value)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
-#endif
-    GL_SAFE_CALL(glUniform2f(location, value.x(), value.y()));
+    setUniform(namedUniform(name), value);
 }
 
 void GlProgram::setUniform(const std::string& name, const QVector3D& value)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
-#endif
-    GL_SAFE_CALL(glUniform3f(location, value.x(), value.y(), value.z()));
+    setUniform(namedUniform(name), value);
 }
 
 void GlProgram::setUniform(const std::string& name, const QVector4D& value)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, const QMatrix3x3& value, bool transpose)
+{
+    setUniform(namedUniform(name), value, transpose);
+}
+
+void GlProgram::setUniform(const std::string& name, const QMatrix4x4& value, bool transpose)
+{
+    setUniform(namedUniform(name), value, transpose);
+}
 #endif
-    GL_SAFE_CALL(glUniform4f(location, value.x(), value.y(), value.z(), value.w()));
+
+void GlProgram::setUniform(const std::string& name, int value)
+{
+    setUniform(namedUniform(name), value);
 }
 
-void GlProgram::setUniform(const std::string& name, const QMatrix3x3& value)
+void GlProgram::setUniform(const std::string& name, float value)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+    setUniform(namedUniform(name), value);
+}
+
+void GlProgram::setUniform(const std::string& name, double value)
+{
+    setUniform(namedUniform(name), value);
+}
+
+#ifdef GLUE_GLM
+void GlProgram::setUniform(UniformHandle uniform, const glm::mat4& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniformMatrix4fv(uniform.location, 1, false, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::vec3& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform3fv(uniform.location, 1, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::vec2& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform2fv(uniform.location, 1, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::vec4& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform4fv(uniform.location, 1, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::mat3& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniformMatrix3fv(uniform.location, 1, false, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::ivec2& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform2iv(uniform.location, 1, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::ivec3& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform3iv(uniform.location, 1, glm::value_ptr(value)));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const glm::ivec4& value)
+{
+    if(updateUniform(uniform.location, glm::value_ptr(value), sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform4iv(uniform.location, 1, glm::value_ptr(value)));
+    }
+}
 #endif
-    GL_SAFE_CALL(glUniformMatrix3fv(location, 1, false, value.constData()));
+
+#ifdef GLUE_QT
+void GlProgram::setUniform(UniformHandle uniform, const QColor& value)
+{
+    const float color[4] = {static_cast<float>(value.redF()),
+                            static_cast<float>(value.greenF()),
+                            static_cast<float>(value.blueF()),
+                            static_cast<float>(value.alphaF())};
+    if(updateUniform(uniform.location, color, sizeof(color)))
+    {
+        GL_SAFE_CALL(glUniform4f(uniform.location, color[0], color[1], color[2], color[3]));
+    }
 }
 
-void GlProgram::setUniform(const std::string& name, const QMatrix4x4& value)
+void GlProgram::setUniform(UniformHandle uniform, const QVector2D& value)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+    const float v[2] = {value.x(), value.y()};
+    if(updateUniform(uniform.location, v, sizeof(v)))
+    {
+        GL_SAFE_CALL(glUniform2f(uniform.location, value.x(), value.y()));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const QVector3D& value)
+{
+    const float v[3] = {value.x(), value.y(), value.z()};
+    if(updateUniform(uniform.location, v, sizeof(v)))
+    {
+        GL_SAFE_CALL(glUniform3f(uniform.location, value.x(), value.y(), value.z()));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const QVector4D& value)
+{
+    const float v[4] = {value.x(), value.y(), value.z(), value.w()};
+    if(updateUniform(uniform.location, v, sizeof(v)))
+    {
+        GL_SAFE_CALL(glUniform4f(uniform.location, value.x(), value.y(), value.z(), value.w()));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const QMatrix3x3& value, bool transpose)
+{
+    // transposed on the CPU, so the shadow copy always holds the uploaded column-major values
+    const QMatrix3x3 matrix = transpose ? value.transposed() : value;
+    if(updateUniform(uniform.location, matrix.constData(), 9 * sizeof(float)))
+    {
+        GL_SAFE_CALL(glUniformMatrix3fv(uniform.location, 1, false, matrix.constData()));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, const QMatrix4x4& value, bool transpose)
+{
+    // transposed on the CPU, so the shadow copy always holds the uploaded column-major values
+    const QMatrix4x4 matrix = transpose ? value.transposed() : value;
+    if(updateUniform(uniform.location, matrix.constData(), 16 * sizeof(float)))
+    {
+        GL_SAFE_CALL(glUniformMatrix4fv(uniform.location, 1, false, matrix.constData()));
+    }
+}
 #endif
-    GL_SAFE_CALL(glUniformMatrix4fv(location, 1, false, value.constData()));
+
+void GlProgram::setUniform(UniformHandle uniform, int value)
+{
+    if(updateUniform(uniform.location, &value, sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform1i(uniform.location, value));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, float value)
+{
+    if(updateUniform(uniform.location, &value, sizeof(value)))
+    {
+        GL_SAFE_CALL(glUniform1f(uniform.location, value));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, double value)
+{
+    setUniform(uniform, static_cast<float>(value));
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<float> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<int> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<unsigned int> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+#ifdef GLUE_GLM
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::vec2> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::vec3> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::vec4> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::ivec2> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::ivec3> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::ivec4> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::mat3> values)
+{
+    setUniform(namedUniform(name), values);
+}
+
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<glm::mat4> values)
+{
+    setUniform(namedUniform(name), values);
 }
 #endif
 
-void GlProgram::setUniform(const std::string& name, int value)
+#ifdef GLUE_QT
+void GlProgram::setUniform(const std::string& name, GlUtils::array_view<QMatrix4x4> values, bool transpose)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+    setUniform(namedUniform(name), values, transpose);
+}
 #endif
-    GL_SAFE_CALL(glUniform1i(location, value));
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<float> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(float)))
+    {
+        GL_SAFE_CALL(glUniform1fv(uniform.location, static_cast<GLsizei>(values.size()), values.data()));
+    }
 }
 
-void GlProgram::setUniform(const std::string& name, float value)
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<int> values)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
-#endif
-    GL_SAFE_CALL(glUniform1f(location, value));
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(int)))
+    {
+        GL_SAFE_CALL(glUniform1iv(uniform.location, static_cast<GLsizei>(values.size()), values.data()));
+    }
 }
 
-void GlProgram::setUniform(const std::string& name, double value)
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<unsigned int> values)
 {
-    int location = getUniformLocation(name);
-#ifdef GLUE_LOGGING
-    if(location < 0) LOG(DEBUG) << "Uniform " << name << " not found";
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(unsigned int)))
+    {
+        GL_SAFE_CALL(glUniform1uiv(uniform.location, static_cast<GLsizei>(values.size()), values.data()));
+    }
+}
+
+#ifdef GLUE_GLM
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::vec2> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::vec2)))
+    {
+        GL_SAFE_CALL(glUniform2fv(uniform.location, static_cast<GLsizei>(values.size()), glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::vec3> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::vec3)))
+    {
+        GL_SAFE_CALL(glUniform3fv(uniform.location, static_cast<GLsizei>(values.size()), glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::vec4> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::vec4)))
+    {
+        GL_SAFE_CALL(glUniform4fv(uniform.location, static_cast<GLsizei>(values.size()), glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::ivec2> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::ivec2)))
+    {
+        GL_SAFE_CALL(glUniform2iv(uniform.location, static_cast<GLsizei>(values.size()), glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::ivec3> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::ivec3)))
+    {
+        GL_SAFE_CALL(glUniform3iv(uniform.location, static_cast<GLsizei>(values.size()), glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::ivec4> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::ivec4)))
+    {
+        GL_SAFE_CALL(glUniform4iv(uniform.location, static_cast<GLsizei>(values.size()), glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::mat3> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::mat3)))
+    {
+        GL_SAFE_CALL(glUniformMatrix3fv(uniform.location, static_cast<GLsizei>(values.size()), false, glm::value_ptr(values[0])));
+    }
+}
+
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<glm::mat4> values)
+{
+    if(!values.empty() && updateUniform(uniform.location, values.data(), values.size() * sizeof(glm::mat4)))
+    {
+        GL_SAFE_CALL(glUniformMatrix4fv(uniform.location, static_cast<GLsizei>(values.size()), false, glm::value_ptr(values[0])));
+    }
+}
 #endif
-    GL_SAFE_CALL(glUniform1f(location, static_cast<float>(value)));
+
+#ifdef GLUE_QT
+void GlProgram::setUniform(UniformHandle uniform, GlUtils::array_view<QMatrix4x4> values, bool transpose)
+{
+    if(values.empty())
+        return;
+
+    // QMatrix4x4 is not a plain array of floats, the matrices are copied into one
+    std::vector<float> data(16 * values.size());
+    for(size_t i=0; i<values.size(); ++i)
+    {
+        const QMatrix4x4 matrix = transpose ? values[i].transposed() : values[i];
+        std::copy(matrix.constData(), matrix.constData() + 16, data.begin() + 16 * i);
+    }
+    if(updateUniform(uniform.location, data.data(), data.size() * sizeof(float)))
+    {
+        GL_SAFE_CALL(glUniformMatrix4fv(uniform.location, static_cast<GLsizei>(values.size()), false, data.data()));
+    }
 }
+#endif
 
 namespace GlUtils
 {
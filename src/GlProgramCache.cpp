@@ -0,0 +1,237 @@
+#include "glue/GlProgramCache.h"
+#include "glue/GlInternal.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    const uint32_t Magic = 0x424c4755; // "UGLB"
+    const uint32_t Version = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+        uint64_t key;
+    };
+
+    uint64_t hash64(GLenum name, uint64_t hash)
+    {
+        const GLubyte* str = GL_SAFE_CALL(glGetString(name));
+        return GlUtils::hash_bytes(str ? std::string(reinterpret_cast<const char*>(str)) : std::string(), hash);
+    }
+}
+
+GlProgramCache::GlProgramCache(const std::string& directory):
+    _directory(directory),
+    _contextHash(0),
+    _available(-1)
+{
+    _statistics.hits = 0;
+    _statistics.misses = 0;
+    _statistics.rejected = 0;
+
+    if(!_directory.empty() && _directory.back() != '/' && _directory.back() != '\\')
+        _directory += '/';
+    if(!_directory.empty())
+    {
+        // fails if the directory already exists
+#ifdef _WIN32
+        _mkdir(_directory.c_str());
+#else
+        mkdir(_directory.c_str(), 0755);
+#endif
+    }
+}
+
+GlProgram* GlProgramCache::load(const std::string& vs, const std::string& fs)
+{
+    return load(vs, nullptr, fs);
+}
+
+GlProgram* GlProgramCache::load(const std::string& vs, const std::string& gs, const std::string& fs)
+{
+    return load(vs, &gs, fs);
+}
+
+GlProgram* GlProgramCache::fromFile(const std::string& vs, const std::string& fs)
+{
+    std::string vsSrc = GlProgram::loadFile(vs);
+    std::string fsSrc = GlProgram::loadFile(fs);
+    return load(vsSrc, fsSrc);
+}
+
+GlProgram* GlProgramCache::fromFile(const std::string& vs, const std::string& gs, const std::string& fs)
+{
+    std::string vsSrc = GlProgram::loadFile(vs);
+    std::string gsSrc = GlProgram::loadFile(gs);
+    std::string fsSrc = GlProgram::loadFile(fs);
+    return load(vsSrc, gsSrc, fsSrc);
+}
+
+bool GlProgramCache::isAvailable() const
+{
+    if(_available < 0)
+    {
+        GLint formats = 0;
+        if(GLAD_GL_ARB_get_program_binary)
+        {
+            GL_SAFE_CALL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+        }
+        _available = formats > 0 ? 1 : 0;
+#ifdef GLUE_LOGGING
+        if(!_available)
+            LOG(INFO) << "Program binaries are not supported, the program cache compiles all programs";
+#endif
+    }
+    return _available != 0;
+}
+
+GlProgramCache::Statistics GlProgramCache::statistics() const
+{
+    return _statistics;
+}
+
+GlProgram* GlProgramCache::load(const std::string& vs, const std::string* gs, const std::string& fs)
+{
+    std::shared_ptr<GlGeometryShader> geometryShader = gs ? std::make_shared<GlGeometryShader>(*gs) : nullptr;
+    GlProgram* program = new GlProgram(std::make_shared<GlVertexShader>(vs), geometryShader, std::make_shared<GlFragmentShader>(fs), nullptr, false);
+
+    if(!isAvailable())
+    {
+        program->startBuild(false);
+        finish(program);
+        return program;
+    }
+
+    const uint64_t k = key(vs, gs, fs);
+    if(read(k, *program))
+    {
+        ++_statistics.hits;
+        return program;
+    }
+
+    program->startBuild(true);
+    finish(program);
+    write(k, *program);
+    return program;
+}
+
+void GlProgramCache::finish(GlProgram* program) const
+{
+    try
+    {
+        program->finish();
+    }
+    catch(...)
+    {
+        delete program;
+        throw;
+    }
+}
+
+uint64_t GlProgramCache::key(const std::string& vs, const std::string* gs, const std::string& fs) const
+{
+    if(_contextHash == 0)
+    {
+        uint64_t hash = GlUtils::hash_bytes(&Version, sizeof(Version));
+        hash = hash64(GL_VENDOR, hash);
+        hash = hash64(GL_RENDERER, hash);
+        _contextHash = hash64(GL_VERSION, hash);
+    }
+
+    // the number of stages distinguishes an empty geometry shader from none
+    const unsigned char stages = gs ? 3 : 2;
+    uint64_t hash = GlUtils::hash_bytes(&stages, sizeof(stages), _contextHash);
+    // the length of each source is hashed as well, so moving text between stages changes the key
+    hash = GlUtils::hash_bytes(vs, hash);
+    if(gs)
+        hash = GlUtils::hash_bytes(*gs, hash);
+    return GlUtils::hash_bytes(fs, hash);
+}
+
+std::string GlProgramCache::path(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return _directory + name;
+}
+
+bool GlProgramCache::read(uint64_t key, GlProgram& program)
+{
+    const std::string filename = path(key);
+    GlUtils::mapped_file file(filename);
+    if(!file)
+    {
+        ++_statistics.misses;
+        return false;
+    }
+
+    Header header;
+    bool valid = file.size() >= sizeof(Header);
+    if(valid)
+    {
+        std::memcpy(&header, file.data(), sizeof(Header));
+        valid = header.magic == Magic && header.version == Version && header.key == key &&
+                header.length == file.size() - sizeof(Header);
+    }
+
+    if(valid && program.loadBinary(header.format, file.data() + sizeof(Header), header.length))
+        return true;
+
+#ifdef GLUE_LOGGING
+    LOG(INFO) << "Program binary " << filename << " was rejected, compiling the program";
+#endif
+    ++_statistics.rejected;
+    std::remove(filename.c_str());
+    return false;
+}
+
+void GlProgramCache::write(uint64_t key, const GlProgram& program) const
+{
+    if(!program._linked)
+        return;
+
+    Header header;
+    std::vector<char> data;
+    if(!program.binary(header.format, data))
+        return;
+    header.magic = Magic;
+    header.version = Version;
+    header.length = static_cast<uint32_t>(data.size());
+    header.key = key;
+
+    // write to a temporary file first, so other processes never read a partial binary
+    const std::string filename = path(key);
+    const std::string temporary = filename + ".tmp";
+    FILE* file = std::fopen(temporary.c_str(), "wb");
+    if(!file)
+    {
+#ifdef GLUE_LOGGING
+        LOG(WARNING) << "Could not write program binary " << temporary;
+#endif
+        return;
+    }
+    const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                         std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    const bool closed = std::fclose(file) == 0;
+    if(!written || !closed)
+    {
+        std::remove(temporary.c_str());
+        return;
+    }
+
+    // rename does not replace existing files on windows
+    std::remove(filename.c_str());
+    std::rename(temporary.c_str(), filename.c_str());
+}
@@ -1,4 +1,5 @@
 #include "glue/GlRenderBuffer.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 
 GlRenderBuffer::GlRenderBuffer():
@@ -6,12 +7,20 @@ GlRenderBuffer::GlRenderBuffer():
     _width(0),
     _height(0)
 {
-    GL_SAFE_CALL(glGenRenderbuffers(1, &_id));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glCreateRenderbuffers(1, &_id));
+    }
+    else
+    {
+        GL_SAFE_CALL(glGenRenderbuffers(1, &_id));
+    }
 }
 
 GlRenderBuffer::~GlRenderBuffer()
 {
-    GL_SAFE_CALL(glDeleteRenderbuffers(1, &_id))
+    GL_SAFE_CALL(glDeleteRenderbuffers(1, &_id));
+    GlState::current().renderBufferDeleted(_id);
 }
 
 GlTexture::InternalFormat GlRenderBuffer::format() const
@@ -39,11 +48,18 @@ int GlRenderBuffer::height() const
 
 void GlRenderBuffer::resize(GlTexture::InternalFormat format, int width, int height)
 {
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glNamedRenderbufferStorage(_id, mapTextureInternalFormat(format), width, height));
+    }
+    else
+    {
 #if defined(GLUE_GL_DEBUG) && defined(GLUE_LOGGING)
-    if(!isBound())
-        LOG(WARNING) << "RenderBuffer is not bound!";
+        if(!isBound())
+            LOG(WARNING) << "RenderBuffer is not bound!";
 #endif
-    GL_SAFE_CALL(glRenderbufferStorage(GL_RENDERBUFFER, mapTextureInternalFormat(format), width, height));
+        GL_SAFE_CALL(glRenderbufferStorage(GL_RENDERBUFFER, mapTextureInternalFormat(format), width, height));
+    }
     _format = format;
     _width = width;
     _height = height;
@@ -51,19 +67,17 @@ void GlRenderBuffer::resize(GlTexture::InternalFormat format, int width, int hei
 
 void GlRenderBuffer::bind()
 {
-    GL_SAFE_CALL(glBindRenderbuffer(GL_RENDERBUFFER, _id));
+    GlState::current().bindRenderBuffer(_id);
 }
 
 void GlRenderBuffer::release()
 {
-    GL_SAFE_CALL(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    GlState::current().bindRenderBuffer(0);
 }
 
 bool GlRenderBuffer::isBound() const
 {
-    GLint currentId = -1;
-    GL_SAFE_CALL(glGetIntegerv(GL_RENDERBUFFER_BINDING, &currentId));
-    return currentId == (GLint)_id;
+    return GlState::current().isRenderBufferBound(_id);
 }
 
 unsigned int GlRenderBuffer::id() const
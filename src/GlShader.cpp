@@ -9,7 +9,8 @@ GlShader::compile_exception::compile_exception(const std::string& errorLog):
 
 GlShader::GlShader(GlShader::Type type, const std::string& source):
 	_type(type),
-	_id(0)
+	_id(0),
+	_submitted(false)
 {
     _id = GL_SAFE_CALL(glCreateShader(mapShaderType(_type)));
 	setSource(source);
@@ -25,22 +26,55 @@ void GlShader::setSource(const std::string& source)
 	const GLchar* src = source.c_str();
 	const GLint length = source.size();
 	GL_SAFE_CALL(glShaderSource(_id, 1, &src, &length));
+	_submitted = false;
 }
 
 void GlShader::compile()
 {
-	GL_SAFE_CALL(glCompileShader(_id));
+	_submitted = false;
+	submit();
 
 	GLint status;
 	GL_SAFE_CALL(glGetShaderiv(_id, GL_COMPILE_STATUS, &status));
 
+	// the log is only fetched on failure, querying it waits for the compiler as well
+	if(status != GL_TRUE)
+	{
 #ifdef GLUE_LOGGING
-    LOG(INFO) << "Shader compiled: " << compileLog();
+		LOG(ERROR) << "Shader compilation failed: " << compileLog();
 #endif
+		throw compile_exception(compileLog());
+	}
+}
 
-	if(status != GL_TRUE)
+void GlShader::submit()
+{
+	if(_submitted)
+		return;
+
+	GL_SAFE_CALL(glCompileShader(_id));
+	_submitted = true;
+}
+
+bool GlShader::isSubmitted() const
+{
+	return _submitted;
+}
+
+bool GlShader::isParallelCompileAvailable()
+{
+	return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
+void GlShader::setMaxCompilerThreads(unsigned int count)
+{
+	if(GLAD_GL_KHR_parallel_shader_compile)
 	{
-		throw compile_exception(compileLog());
+		GL_SAFE_CALL(glMaxShaderCompilerThreadsKHR(count));
+	}
+	else if(GLAD_GL_ARB_parallel_shader_compile)
+	{
+		GL_SAFE_CALL(glMaxShaderCompilerThreadsARB(count));
 	}
 }
 
@@ -90,3 +124,10 @@ GlFragmentShader::GlFragmentShader(const std::string& source):
 {
 
 }
+
+
+GlComputeShader::GlComputeShader(const std::string& source):
+	GlShader(ComputeShader, source)
+{
+
+}
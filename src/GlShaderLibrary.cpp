@@ -0,0 +1,214 @@
+#include "glue/GlShaderLibrary.h"
+#include "glue/GlUtils.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // includes nested deeper than this are most likely a cycle through different names
+    const size_t MaxIncludeDepth = 32;
+
+    GlShaderLibrary::Defines sorted(const GlShaderLibrary::Defines& defines)
+    {
+        GlShaderLibrary::Defines result(defines);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // returns the directive of a preprocessor line without the '#', e.g. "version 330 core", or an empty string
+    std::string directive(const std::string& line)
+    {
+        size_t begin = line.find_first_not_of(" \t");
+        if(begin == std::string::npos || line[begin] != '#')
+            return "";
+        begin = line.find_first_not_of(" \t", begin + 1);
+        return begin != std::string::npos ? line.substr(begin) : "";
+    }
+
+    bool startsWith(const std::string& str, const char* prefix)
+    {
+        return str.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+    }
+}
+
+GlShaderLibrary::GlShaderLibrary(const std::string& includeDirectory):
+    _includeDirectory(includeDirectory)
+{
+    _statistics.hits = 0;
+    _statistics.misses = 0;
+
+    if(!_includeDirectory.empty() && _includeDirectory.back() != '/' && _includeDirectory.back() != '\\')
+        _includeDirectory += '/';
+}
+
+void GlShaderLibrary::addInclude(const std::string& name, const std::string& source)
+{
+    _includes[name] = source;
+}
+
+std::string GlShaderLibrary::preprocess(const std::string& source, const Defines& defines) const
+{
+    // the defines must follow the #version line, which must be the first directive
+    size_t bodyBegin = 0;
+    unsigned int firstLine = 1;
+    unsigned int lineNumber = 1;
+    for(size_t begin=0; begin<source.size(); ++lineNumber)
+    {
+        size_t end = source.find('\n', begin);
+        end = end != std::string::npos ? end + 1 : source.size();
+        const std::string line = directive(source.substr(begin, end - begin));
+        if(startsWith(line, "version"))
+        {
+            bodyBegin = end;
+            firstLine = lineNumber + 1;
+            break;
+        }
+        if(!line.empty())
+            break;
+        begin = end;
+    }
+
+    std::string out = source.substr(0, bodyBegin);
+    if(!out.empty() && out.back() != '\n')
+        out += '\n';
+    for(const auto& define: sorted(defines))
+        out += "#define " + define.first + " " + define.second + "\n";
+    out += "#line " + std::to_string(firstLine) + " 0\n";
+
+    std::vector<std::string> stack;
+    std::vector<std::string> included;
+    expand(source.substr(bodyBegin), 0, firstLine, stack, included, out);
+    return out;
+}
+
+std::shared_ptr<GlVertexShader> GlShaderLibrary::vertexShader(const std::string& source, const Defines& defines)
+{
+    return variant<GlVertexShader>(GlShader::VertexShader, source, defines);
+}
+
+std::shared_ptr<GlGeometryShader> GlShaderLibrary::geometryShader(const std::string& source, const Defines& defines)
+{
+    return variant<GlGeometryShader>(GlShader::GeometryShader, source, defines);
+}
+
+std::shared_ptr<GlFragmentShader> GlShaderLibrary::fragmentShader(const std::string& source, const Defines& defines)
+{
+    return variant<GlFragmentShader>(GlShader::FragmentShader, source, defines);
+}
+
+std::shared_ptr<GlComputeShader> GlShaderLibrary::computeShader(const std::string& source, const Defines& defines)
+{
+    return variant<GlComputeShader>(GlShader::ComputeShader, source, defines);
+}
+
+size_t GlShaderLibrary::size() const
+{
+    return _variants.size();
+}
+
+size_t GlShaderLibrary::collect()
+{
+    size_t removed = 0;
+    for(auto it=_variants.begin(); it!=_variants.end(); )
+    {
+        if(it->second.use_count() == 1)
+        {
+            it = _variants.erase(it);
+            ++removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+void GlShaderLibrary::clear()
+{
+    _variants.clear();
+}
+
+GlShaderLibrary::Statistics GlShaderLibrary::statistics() const
+{
+    return _statistics;
+}
+
+template<class T>
+std::shared_ptr<T> GlShaderLibrary::variant(GlShader::Type type, const std::string& source, const Defines& defines)
+{
+    const Defines sortedDefines = sorted(defines);
+    const uint32_t stage = static_cast<uint32_t>(type);
+    uint64_t key = GlUtils::hash_bytes(&stage, sizeof(stage));
+    key = GlUtils::hash_bytes(source, key);
+    for(const auto& define: sortedDefines)
+        key = GlUtils::hash_bytes(define.second, GlUtils::hash_bytes(define.first, key));
+
+    auto it = _variants.find(key);
+    if(it != _variants.end())
+    {
+        ++_statistics.hits;
+        return std::static_pointer_cast<T>(it->second);
+    }
+
+    ++_statistics.misses;
+    std::shared_ptr<T> shader = std::make_shared<T>(preprocess(source, sortedDefines));
+    shader->submit();
+    _variants[key] = shader;
+    return shader;
+}
+
+void GlShaderLibrary::expand(const std::string& source, unsigned int sourceNumber, unsigned int firstLine,
+                             std::vector<std::string>& stack, std::vector<std::string>& included, std::string& out) const
+{
+    unsigned int lineNumber = firstLine;
+    for(size_t begin=0; begin<source.size(); ++lineNumber)
+    {
+        size_t end = source.find('\n', begin);
+        end = end != std::string::npos ? end : source.size();
+        const std::string line = source.substr(begin, end - begin);
+        begin = end + 1;
+
+        const std::string dir = directive(line);
+        if(!startsWith(dir, "include"))
+        {
+            out += line;
+            out += '\n';
+            continue;
+        }
+
+        const size_t open = dir.find_first_of("\"<");
+        const size_t close = open != std::string::npos ? dir.find_first_of("\">", open + 1) : std::string::npos;
+        if(close == std::string::npos)
+            throw std::runtime_error("Invalid include directive: " + line);
+        const std::string name = dir.substr(open + 1, close - open - 1);
+
+        if(std::find(stack.begin(), stack.end(), name) != stack.end() || stack.size() >= MaxIncludeDepth)
+            throw std::runtime_error("Recursive include of " + name);
+
+        // source string 0 is the main source
+        auto it = std::find(included.begin(), included.end(), name);
+        const unsigned int number = static_cast<unsigned int>(it - included.begin()) + 1;
+        if(it == included.end())
+            included.push_back(name);
+
+        out += "#line 1 " + std::to_string(number) + "\n";
+        stack.push_back(name);
+        expand(include(name), number, 1, stack, included, out);
+        stack.pop_back();
+        out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+    }
+}
+
+std::string GlShaderLibrary::include(const std::string& name) const
+{
+    auto it = _includes.find(name);
+    if(it != _includes.end())
+        return it->second;
+
+    std::string source;
+    if(!GlUtils::read_file(_includeDirectory + name, source))
+        throw std::runtime_error("Could not open include " + name);
+    return source;
+}
@@ -0,0 +1,380 @@
+#include "glue/GlState.h"
+#include "glue/GlInternal.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    const unsigned int Unknown = 0xffffffff;
+
+    thread_local GlState* currentState = nullptr;
+
+    GlState& defaultState()
+    {
+        thread_local GlState state;
+        return state;
+    }
+
+    GLenum textureBinding(unsigned int type)
+    {
+        switch(static_cast<GlTexture::Type>(type))
+        {
+        case GlTexture::Type::Texture1D: return GL_TEXTURE_BINDING_1D;
+        case GlTexture::Type::Texture2D: return GL_TEXTURE_BINDING_2D;
+        case GlTexture::Type::Texture3D: return GL_TEXTURE_BINDING_3D;
+        }
+        return GL_NONE;
+    }
+}
+
+GlState::GlState():
+    _bindings(NumFixedSlots, Unknown),
+    _activeUnit(Unknown),
+    _verify(false),
+    _directStateAccess(true)
+{
+    _statistics.issued = 0;
+    _statistics.skipped = 0;
+}
+
+GlState& GlState::current()
+{
+    return currentState ? *currentState : defaultState();
+}
+
+void GlState::setCurrent(GlState* state)
+{
+    currentState = state;
+}
+
+void GlState::invalidate()
+{
+    std::fill(_bindings.begin(), _bindings.end(), Unknown);
+    _storageBindings.clear();
+    _uniformBindings.clear();
+    _activeUnit = Unknown;
+}
+
+void GlState::setVerify(bool verify)
+{
+    _verify = verify;
+}
+
+bool GlState::verify() const
+{
+    return _verify;
+}
+
+GlState::Statistics GlState::statistics() const
+{
+    return _statistics;
+}
+
+bool GlState::directStateAccess() const
+{
+    return _directStateAccess && GLAD_GL_ARB_direct_state_access;
+}
+
+void GlState::setDirectStateAccess(bool enable)
+{
+    _directStateAccess = enable;
+}
+
+void GlState::bindBuffer(GlBuffer::Target target, unsigned int id)
+{
+    if(bind(bufferSlot(target), id))
+    {
+        GL_SAFE_CALL(glBindBuffer(mapBufferTarget(target), id));
+    }
+}
+
+void GlState::bindBufferBase(GlBuffer::Target target, unsigned int index, unsigned int id)
+{
+    if(bindIndexed(target, index, id, 0, 0))
+    {
+        GL_SAFE_CALL(glBindBufferBase(mapBufferTarget(target), index, id));
+    }
+}
+
+void GlState::bindBufferRange(GlBuffer::Target target, unsigned int index, unsigned int id, size_t offset, size_t size)
+{
+    assert(size > 0);
+    if(bindIndexed(target, index, id, offset, size))
+    {
+        GL_SAFE_CALL(glBindBufferRange(mapBufferTarget(target), index, id, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size)));
+    }
+}
+
+bool GlState::isBufferBound(GlBuffer::Target target, unsigned int id)
+{
+    return isBound(bufferSlot(target), id);
+}
+
+void GlState::bindVertexArray(unsigned int id)
+{
+    if(bind(VertexArray, id))
+    {
+        GL_SAFE_CALL(glBindVertexArray(id));
+        // the element array binding is part of the vertex array
+        _bindings[ElementArrayBuffer] = Unknown;
+    }
+}
+
+bool GlState::isVertexArrayBound(unsigned int id)
+{
+    return isBound(VertexArray, id);
+}
+
+void GlState::useProgram(unsigned int id)
+{
+    if(bind(Program, id))
+    {
+        GL_SAFE_CALL(glUseProgram(id));
+    }
+}
+
+bool GlState::isProgramUsed(unsigned int id)
+{
+    return isBound(Program, id);
+}
+
+void GlState::activeTexture(unsigned int unit)
+{
+#ifdef GLUE_LOGGING
+    if(_verify && _activeUnit != Unknown)
+    {
+        GLint active = 0;
+        GL_SAFE_CALL(glGetIntegerv(GL_ACTIVE_TEXTURE, &active));
+        if(static_cast<unsigned int>(active - GL_TEXTURE0) != _activeUnit)
+            LOG(ERROR) << "GlState: cached active texture unit " << _activeUnit << " but GL has " << active - GL_TEXTURE0;
+    }
+#endif
+
+    if(unit == _activeUnit && !_verify)
+    {
+        ++_statistics.skipped;
+        return;
+    }
+    ++_statistics.issued;
+    GL_SAFE_CALL(glActiveTexture(GL_TEXTURE0 + unit));
+    _activeUnit = unit;
+}
+
+void GlState::bindTexture(GlTexture::Type type, unsigned int id)
+{
+    if(bind(textureSlot(type), id))
+    {
+        GL_SAFE_CALL(glBindTexture(mapTextureType(type), id));
+    }
+}
+
+bool GlState::isTextureBound(GlTexture::Type type, unsigned int id)
+{
+    return isBound(textureSlot(type), id);
+}
+
+void GlState::bindFrameBuffer(GlFrameBuffer::Target target, unsigned int id)
+{
+    // both bindings are checked, so an unchanged draw binding does not hide a changed read binding
+    const bool draw = target != GlFrameBuffer::Target::ReadBuffer && bind(DrawFrameBuffer, id);
+    const bool read = target != GlFrameBuffer::Target::DrawBuffer && bind(ReadFrameBuffer, id);
+    if(draw || read)
+    {
+        GL_SAFE_CALL(glBindFramebuffer(mapFrameBufferTarget(target), id));
+    }
+}
+
+bool GlState::isFrameBufferBound(unsigned int id)
+{
+    return isBound(DrawFrameBuffer, id) || isBound(ReadFrameBuffer, id);
+}
+
+void GlState::bindRenderBuffer(unsigned int id)
+{
+    if(bind(RenderBuffer, id))
+    {
+        GL_SAFE_CALL(glBindRenderbuffer(GL_RENDERBUFFER, id));
+    }
+}
+
+bool GlState::isRenderBufferBound(unsigned int id)
+{
+    return isBound(RenderBuffer, id);
+}
+
+void GlState::bufferDeleted(unsigned int id)
+{
+    deleted(ArrayBuffer, UniformBuffer + 1, id);
+    // deleting a buffer resets the indexed binding points it was bound to
+    for(auto bindings: {&_storageBindings, &_uniformBindings})
+    {
+        for(auto& binding: *bindings)
+        {
+            if(binding.id == id)
+                binding = IndexedBinding{0, 0, 0};
+        }
+    }
+}
+
+void GlState::vertexArrayDeleted(unsigned int id)
+{
+    if(_bindings[VertexArray] == id)
+    {
+        _bindings[VertexArray] = 0;
+        _bindings[ElementArrayBuffer] = Unknown;
+    }
+}
+
+void GlState::textureDeleted(unsigned int id)
+{
+    deleted(NumFixedSlots, _bindings.size(), id);
+}
+
+void GlState::frameBufferDeleted(unsigned int id)
+{
+    deleted(DrawFrameBuffer, ReadFrameBuffer + 1, id);
+}
+
+void GlState::renderBufferDeleted(unsigned int id)
+{
+    deleted(RenderBuffer, RenderBuffer + 1, id);
+}
+
+bool GlState::bind(size_t slot, unsigned int id)
+{
+    unsigned int& binding = cached(slot);
+    if(binding == id && !_verify)
+    {
+        ++_statistics.skipped;
+        return false;
+    }
+
+#ifdef GLUE_LOGGING
+    if(_verify && binding != Unknown && binding != query(slot))
+        LOG(ERROR) << "GlState: cached binding " << binding << " of slot " << slot << " does not match GL binding " << query(slot);
+#endif
+
+    ++_statistics.issued;
+    binding = id;
+    return true;
+}
+
+bool GlState::isBound(size_t slot, unsigned int id)
+{
+    unsigned int& binding = cached(slot);
+    if(binding == Unknown)
+    {
+        binding = query(slot);
+    }
+#ifdef GLUE_LOGGING
+    else if(_verify && binding != query(slot))
+    {
+        LOG(ERROR) << "GlState: cached binding " << binding << " of slot " << slot << " does not match GL binding " << query(slot);
+    }
+#endif
+    return binding == id;
+}
+
+unsigned int GlState::query(size_t slot) const
+{
+    GLenum name = GL_NONE;
+    switch(slot)
+    {
+    case ArrayBuffer: name = GL_ARRAY_BUFFER_BINDING; break;
+    case ElementArrayBuffer: name = GL_ELEMENT_ARRAY_BUFFER_BINDING; break;
+    case DrawIndirectBuffer:
+        if(!GLAD_GL_ARB_draw_indirect)
+            return 0;
+        name = GL_DRAW_INDIRECT_BUFFER_BINDING;
+        break;
+    case DispatchIndirectBuffer:
+        if(!GLAD_GL_ARB_compute_shader)
+            return 0;
+        name = GL_DISPATCH_INDIRECT_BUFFER_BINDING;
+        break;
+    case ShaderStorageBuffer:
+        if(!GLAD_GL_ARB_shader_storage_buffer_object)
+            return 0;
+        name = GL_SHADER_STORAGE_BUFFER_BINDING;
+        break;
+    case UniformBuffer: name = GL_UNIFORM_BUFFER_BINDING; break;
+    case VertexArray: name = GL_VERTEX_ARRAY_BINDING; break;
+    case Program: name = GL_CURRENT_PROGRAM; break;
+    case DrawFrameBuffer: name = GL_DRAW_FRAMEBUFFER_BINDING; break;
+    case ReadFrameBuffer: name = GL_READ_FRAMEBUFFER_BINDING; break;
+    case RenderBuffer: name = GL_RENDERBUFFER_BINDING; break;
+    default:
+        // texture slots are only queried for the active unit
+        name = textureBinding((slot - NumFixedSlots) % NumTextureTypes);
+        break;
+    }
+
+    GLint id = 0;
+    GL_SAFE_CALL(glGetIntegerv(name, &id));
+    return static_cast<unsigned int>(id);
+}
+
+unsigned int& GlState::cached(size_t slot)
+{
+    if(slot >= _bindings.size())
+        _bindings.resize(slot + 1, Unknown);
+    return _bindings[slot];
+}
+
+size_t GlState::bufferSlot(GlBuffer::Target target) const
+{
+    switch(target)
+    {
+    case GlBuffer::Target::Array: return ArrayBuffer;
+    case GlBuffer::Target::ElementArray: return ElementArrayBuffer;
+    case GlBuffer::Target::DrawIndirect: return DrawIndirectBuffer;
+    case GlBuffer::Target::DispatchIndirect: return DispatchIndirectBuffer;
+    case GlBuffer::Target::ShaderStorage: return ShaderStorageBuffer;
+    case GlBuffer::Target::Uniform: return UniformBuffer;
+    }
+    assert(false);
+    return ArrayBuffer;
+}
+
+size_t GlState::textureSlot(GlTexture::Type type)
+{
+    if(_activeUnit == Unknown)
+    {
+        GLint active = GL_TEXTURE0;
+        GL_SAFE_CALL(glGetIntegerv(GL_ACTIVE_TEXTURE, &active));
+        _activeUnit = static_cast<unsigned int>(active - GL_TEXTURE0);
+    }
+    return NumFixedSlots + _activeUnit * NumTextureTypes + static_cast<unsigned int>(type);
+}
+
+void GlState::deleted(size_t first, size_t last, unsigned int id)
+{
+    for(size_t slot=first; slot<last && slot<_bindings.size(); ++slot)
+    {
+        if(_bindings[slot] == id)
+            _bindings[slot] = 0;
+    }
+}
+
+bool GlState::bindIndexed(GlBuffer::Target target, unsigned int index, unsigned int id, size_t offset, size_t size)
+{
+    assert(target == GlBuffer::Target::ShaderStorage || target == GlBuffer::Target::Uniform);
+    std::vector<IndexedBinding>& bindings = target == GlBuffer::Target::Uniform ? _uniformBindings : _storageBindings;
+    if(index >= bindings.size())
+        bindings.resize(index + 1, IndexedBinding{Unknown, 0, 0});
+
+    // indexed bindings are not cross-checked, verify mode always reaches the driver
+    IndexedBinding& binding = bindings[index];
+    if(binding.id == id && binding.offset == offset && binding.size == size && !_verify)
+    {
+        ++_statistics.skipped;
+        return false;
+    }
+
+    ++_statistics.issued;
+    binding = IndexedBinding{id, offset, size};
+    // binding an index also changes the generic binding of the target
+    cached(bufferSlot(target)) = id;
+    return true;
+}
@@ -0,0 +1,224 @@
+#include "glue/GlStreamBuffer.h"
+#include "glue/GlInternal.h"
+#include <cassert>
+
+GlStreamBuffer::GlStreamBuffer(Target target):
+    GlBuffer(target),
+    _frameSize(0),
+    _frame(0),
+    _cursor(0),
+    _persistent(false),
+    _immutable(false),
+    _mapping(nullptr),
+    _mappedOffset(0)
+{
+
+}
+
+GlStreamBuffer::~GlStreamBuffer()
+{
+    // deleting the buffer implicitly unmaps it
+    deleteFences();
+}
+
+void GlStreamBuffer::allocateStorage(size_t frameSize, unsigned int numFrames)
+{
+#ifdef GLUE_LOGGING
+    if(!useDirectStateAccess() && !isBound()) LOG(DEBUG) << "Buffer is not bound!";
+#endif
+
+    assert(frameSize > 0 && numFrames > 0);
+
+    deleteFences();
+    _fences.assign(numFrames, nullptr);
+    _frameSize = frameSize;
+    // the first beginFrame advances to region 0
+    _frame = numFrames - 1;
+    _cursor = 0;
+    _mapping = nullptr;
+    _mappedOffset = 0;
+    _size = frameSize * numFrames;
+    _usage = Usage::StreamDraw;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if(GLAD_GL_ARB_buffer_storage)
+    {
+        if(useDirectStateAccess())
+        {
+            GL_SAFE_CALL(glNamedBufferStorage(_id, (GLsizeiptr)_size, nullptr, flags));
+        }
+        else
+        {
+            GL_SAFE_CALL(glBufferStorage(mapBufferTarget(_target), (GLsizeiptr)_size, nullptr, flags));
+        }
+        _immutable = true;
+        _mapping = static_cast<char*>(map(0, _size, MapWrite | MapPersistent | MapCoherent));
+        _persistent = _mapping != nullptr;
+#ifdef GLUE_LOGGING
+        if(!_persistent) LOG(WARNING) << "Persistent mapping of StreamBuffer failed, regions are mapped per frame";
+#endif
+    }
+    else
+    {
+        setData(_usage, nullptr, _size);
+        _immutable = false;
+        _persistent = false;
+    }
+}
+
+void GlStreamBuffer::beginFrame()
+{
+#ifdef GLUE_LOGGING
+    if(!useDirectStateAccess() && !isBound()) LOG(DEBUG) << "Buffer is not bound!";
+#endif
+
+    assert(!_fences.empty());
+
+    commit();
+
+    _frame = (_frame + 1) % _fences.size();
+    _cursor = 0;
+
+    if(!_fences[_frame])
+        return;
+
+    if(_persistent || _immutable)
+    {
+        // the region is written through the persistent mapping or immutable storage can not be orphaned,
+        // so the GPU must be done with it
+        waitForFence(_frame);
+    }
+    else
+    {
+        GLsync fence = static_cast<GLsync>(_fences[_frame]);
+        GLenum result = GL_SAFE_CALL(glClientWaitSync(fence, 0, 0));
+        if(result == GL_TIMEOUT_EXPIRED)
+        {
+            // the region is still in use: orphan the storage instead of stalling
+            // all fences refer to the old storage afterwards and are not needed anymore
+            setData(_usage, nullptr, _size);
+            deleteFences();
+        }
+        else
+        {
+            GL_SAFE_CALL(glDeleteSync(fence));
+            _fences[_frame] = nullptr;
+        }
+    }
+}
+
+GlStreamBuffer::Allocation GlStreamBuffer::allocate(size_t size, size_t alignment)
+{
+#ifdef GLUE_LOGGING
+    if(!useDirectStateAccess() && !isBound()) LOG(DEBUG) << "Buffer is not bound!";
+#endif
+
+    assert(alignment > 0);
+
+    Allocation allocation;
+    allocation.data = nullptr;
+    allocation.offset = 0;
+    allocation.size = 0;
+
+    const size_t regionBegin = _frame * _frameSize;
+    const size_t offset = (regionBegin + _cursor + alignment - 1) / alignment * alignment;
+    if(offset + size > regionBegin + _frameSize)
+    {
+#ifdef GLUE_LOGGING
+        LOG(WARNING) << "StreamBuffer frame region is full (" << _frameSize << " bytes)";
+#endif
+        return allocation;
+    }
+
+    if(!_persistent && !_mapping)
+    {
+        // only map the unused part of the region
+        // the fences guarantee that the GPU does not read it, so no synchronization is required
+        _mappedOffset = offset;
+        void* mapping = map(_mappedOffset, regionBegin + _frameSize - _mappedOffset, MapWrite | MapInvalidateRange | MapUnsynchronized | MapFlushExplicit);
+        _mapping = static_cast<char*>(mapping);
+        if(!_mapping)
+            return allocation;
+    }
+
+    _cursor = offset + size - regionBegin;
+
+    allocation.data = _persistent ? _mapping + offset : _mapping + (offset - _mappedOffset);
+    allocation.offset = offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void GlStreamBuffer::commit()
+{
+    if(_persistent || !_mapping)
+        return;
+
+    const size_t written = _frame * _frameSize + _cursor - _mappedOffset;
+    if(written > 0)
+        flushRange(0, written);
+    unmap();
+    _mapping = nullptr;
+}
+
+void GlStreamBuffer::endFrame()
+{
+    assert(!_fences.empty());
+
+    commit();
+
+    if(_fences[_frame])
+    {
+        GL_SAFE_CALL(glDeleteSync(static_cast<GLsync>(_fences[_frame])));
+    }
+    GLsync fence = GL_SAFE_CALL(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    _fences[_frame] = fence;
+}
+
+bool GlStreamBuffer::isPersistent() const
+{
+    return _persistent;
+}
+
+size_t GlStreamBuffer::frameSize() const
+{
+    return _frameSize;
+}
+
+unsigned int GlStreamBuffer::numFrames() const
+{
+    return _fences.size();
+}
+
+size_t GlStreamBuffer::used() const
+{
+    return _cursor;
+}
+
+void GlStreamBuffer::waitForFence(unsigned int frame)
+{
+    GLsync fence = static_cast<GLsync>(_fences[frame]);
+    GLenum result = GL_TIMEOUT_EXPIRED;
+    while(result == GL_TIMEOUT_EXPIRED)
+    {
+        // flush the command queue, otherwise the fence might never be signaled
+        result = GL_SAFE_CALL(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+    }
+#ifdef GLUE_LOGGING
+    if(result == GL_WAIT_FAILED) LOG(WARNING) << "Waiting for StreamBuffer fence failed";
+#endif
+    GL_SAFE_CALL(glDeleteSync(fence));
+    _fences[frame] = nullptr;
+}
+
+void GlStreamBuffer::deleteFences()
+{
+    for(auto& fence: _fences)
+    {
+        if(fence)
+        {
+            GL_SAFE_CALL(glDeleteSync(static_cast<GLsync>(fence)));
+            fence = nullptr;
+        }
+    }
+}
@@ -1,17 +1,26 @@
 #include "glue/GlTexture.h"
 #include "glue/GlTexture2D.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 
-GlTexture::GlTexture():
+GlTexture::GlTexture(Type type):
     _id(-1),
     _format(InternalFormat::Invalid)
 {
-    GL_SAFE_CALL(glGenTextures(1, &_id));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glCreateTextures(mapTextureType(type), 1, &_id));
+    }
+    else
+    {
+        GL_SAFE_CALL(glGenTextures(1, &_id));
+    }
 }
 
 GlTexture::~GlTexture()
 {
     GL_SAFE_CALL(glDeleteTextures(1, &_id));
+    GlState::current().textureDeleted(_id);
 }
 
 unsigned int GlTexture::id() const
@@ -35,27 +44,42 @@ bool GlTexture::hasDepthFormat() const
 void GlTexture::bind(int unit)
 {
     if(unit >= 0)
-    {
-        GL_SAFE_CALL(glActiveTexture(GL_TEXTURE0+unit));
-    }
-    GL_SAFE_CALL(glBindTexture(mapTextureType(type()), _id));
+        GlState::current().activeTexture(unit);
+    GlState::current().bindTexture(type(), _id);
 }
 
 void GlTexture::release(int unit)
 {
     if(unit >= 0)
-    {
-        GL_SAFE_CALL(glActiveTexture(GL_TEXTURE0+unit));
-    }
-    GL_SAFE_CALL(glBindTexture(mapTextureType(type()), 0));
+        GlState::current().activeTexture(unit);
+    GlState::current().bindTexture(type(), 0);
 }
 
 void GlTexture::setMinFilter(GlTexture::MinFilter filter)
 {
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MIN_FILTER, mapMinFilter(filter)));
+    setParameter(GL_TEXTURE_MIN_FILTER, mapMinFilter(filter));
 }
 
 void GlTexture::setMagFilter(GlTexture::MagFilter filter)
 {
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAG_FILTER, mapMagFilter(filter)));
+    setParameter(GL_TEXTURE_MAG_FILTER, mapMagFilter(filter));
+}
+
+void GlTexture::setParameter(unsigned int name, int value)
+{
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glTextureParameteri(_id, name, value));
+    }
+    else
+    {
+        GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), name, value));
+    }
+}
+
+void GlTexture::prepareImage()
+{
+    // glTexImage* has no direct state access variant, so the texture is bound to the active unit
+    if(useDirectStateAccess())
+        bind();
 }
@@ -1,7 +1,9 @@
 #include "glue/GlTexture1D.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 
 GlTexture1D::GlTexture1D():
+    GlTexture(Type::Texture1D),
     _width(0)
 {
 
@@ -14,6 +16,16 @@ GlTexture::Type GlTexture1D::type() const
 
 void GlTexture1D::setImageData(GlTexture::InternalFormat format, int width, GlTexture::PixelFormat pixelFormat, GlTexture::PixelType pixelType, const void* pixeldata)
 {
+    if(useDirectStateAccess() && format == _format && width == _width)
+    {
+        // the storage does not change, only the content is replaced
+        if(pixeldata)
+        {
+            GL_SAFE_CALL(glTextureSubImage1D(_id, 0, 0, width, mapTexturePixelFormat(pixelFormat), mapTexturePixelType(pixelType), pixeldata));
+        }
+        return;
+    }
+    prepareImage();
 #if defined(GLUE_GL_DEBUG) && defined(GLUE_LOGGING)
     if(!isBound())
         LOG(WARNING) << "Texture1D is not bound!";
@@ -22,12 +34,16 @@ void GlTexture1D::setImageData(GlTexture::InternalFormat format, int width, GlTe
     _format = format;
     _width = width;
     // disable default midmap levels
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_BASE_LEVEL, 0));
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAX_LEVEL, 0));
+    setParameter(GL_TEXTURE_BASE_LEVEL, 0);
+    setParameter(GL_TEXTURE_MAX_LEVEL, 0);
 }
 
 void GlTexture1D::resize(GlTexture::InternalFormat format, int width)
 {
+    // the content is undefined after resizing, so the storage is kept if it does not change
+    if(useDirectStateAccess() && format == _format && width == _width)
+        return;
+    prepareImage();
 #if defined(GLUE_GL_DEBUG) && defined(GLUE_LOGGING)
     if(!isBound())
         LOG(WARNING) << "Texture1D is not bound!";
@@ -36,8 +52,8 @@ void GlTexture1D::resize(GlTexture::InternalFormat format, int width)
     _format = format;
     _width = width;
     // disable default midmap levels
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_BASE_LEVEL, 0));
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAX_LEVEL, 0));
+    setParameter(GL_TEXTURE_BASE_LEVEL, 0);
+    setParameter(GL_TEXTURE_MAX_LEVEL, 0);
 }
 
 int GlTexture1D::width()
@@ -47,8 +63,6 @@ int GlTexture1D::width()
 
 bool GlTexture1D::isBound() const
 {
-    GLint currentId = -1;
-    GL_SAFE_CALL(glGetIntegerv(GL_TEXTURE_BINDING_1D, &currentId));
-    return currentId == (GLint)_id;
+    return GlState::current().isTextureBound(type(), _id);
 }
 
@@ -1,4 +1,5 @@
 #include "glue/GlTexture2D.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 
 #include <png.h>
@@ -7,6 +8,7 @@
 #define PNGSIGSIZE 8
 
 GlTexture2D::GlTexture2D():
+    GlTexture(Type::Texture2D),
     _width(0),
     _height(0)
 {
@@ -20,6 +22,16 @@ GlTexture::Type GlTexture2D::type() const
 
 void GlTexture2D::setImageData(GlTexture::InternalFormat format, int width, int height, GlTexture::PixelFormat pixelFormat, GlTexture::PixelType pixelType, const void* pixeldata)
 {
+    if(useDirectStateAccess() && format == _format && width == _width && height == _height)
+    {
+        // the storage does not change, only the content is replaced
+        if(pixeldata)
+        {
+            GL_SAFE_CALL(glTextureSubImage2D(_id, 0, 0, 0, width, height, mapTexturePixelFormat(pixelFormat), mapTexturePixelType(pixelType), pixeldata));
+        }
+        return;
+    }
+    prepareImage();
 #if defined(GLUE_GL_DEBUG) && defined(GLUE_LOGGING)
     if(!isBound())
         LOG(WARNING) << "Texture2D is not bound!";
@@ -29,12 +41,16 @@ void GlTexture2D::setImageData(GlTexture::InternalFormat format, int width, int
     _width = width;
     _height = height;
     // disable default midmap levels
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_BASE_LEVEL, 0));
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAX_LEVEL, 0));
+    setParameter(GL_TEXTURE_BASE_LEVEL, 0);
+    setParameter(GL_TEXTURE_MAX_LEVEL, 0);
 }
 
 void GlTexture2D::resize(GlTexture::InternalFormat format, int width, int height)
 {
+    // the content is undefined after resizing, so the storage is kept if it does not change
+    if(useDirectStateAccess() && format == _format && width == _width && height == _height)
+        return;
+    prepareImage();
 #if defined(GLUE_GL_DEBUG) && defined(GLUE_LOGGING)
     if(!isBound())
         LOG(WARNING) << "Texture2D is not bound!";
@@ -44,8 +60,8 @@ void GlTexture2D::resize(GlTexture::InternalFormat format, int width, int height
     _width = width;
     _height = height;
     // disable default midmap levels
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_BASE_LEVEL, 0));
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAX_LEVEL, 0));
+    setParameter(GL_TEXTURE_BASE_LEVEL, 0);
+    setParameter(GL_TEXTURE_MAX_LEVEL, 0);
 }
 
 int GlTexture2D::width()
@@ -60,9 +76,7 @@ int GlTexture2D::height()
 
 bool GlTexture2D::isBound() const
 {
-    GLint currentId = -1;
-    GL_SAFE_CALL(glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentId));
-    return currentId == (GLint)_id;
+    return GlState::current().isTextureBound(type(), _id);
 }
 
 #ifdef GLUE_LIBPNG
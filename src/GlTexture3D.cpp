@@ -1,7 +1,9 @@
 #include "glue/GlTexture3D.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
 
 GlTexture3D::GlTexture3D():
+    GlTexture(Type::Texture3D),
     _width(0),
     _height(0),
     _depth(0)
@@ -16,6 +18,16 @@ GlTexture::Type GlTexture3D::type() const
 
 void GlTexture3D::setImageData(GlTexture::InternalFormat format, int width, int height, int depth, GlTexture::PixelFormat pixelFormat, GlTexture::PixelType pixelType, const void* pixeldata)
 {
+    if(useDirectStateAccess() && format == _format && width == _width && height == _height && depth == _depth)
+    {
+        // the storage does not change, only the content is replaced
+        if(pixeldata)
+        {
+            GL_SAFE_CALL(glTextureSubImage3D(_id, 0, 0, 0, 0, width, height, depth, mapTexturePixelFormat(pixelFormat), mapTexturePixelType(pixelType), pixeldata));
+        }
+        return;
+    }
+    prepareImage();
 #ifdef GLUE_LOGGING
     if(!isBound())
         LOG(DEBUG) << "Texture3D is not bound!";
@@ -26,12 +38,16 @@ void GlTexture3D::setImageData(GlTexture::InternalFormat format, int width, int
     _height = height;
     _depth = depth;
     // disable default midmap levels
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_BASE_LEVEL, 0));
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAX_LEVEL, 0));
+    setParameter(GL_TEXTURE_BASE_LEVEL, 0);
+    setParameter(GL_TEXTURE_MAX_LEVEL, 0);
 }
 
 void GlTexture3D::resize(GlTexture::InternalFormat format, int width, int height, int depth)
 {
+    // the content is undefined after resizing, so the storage is kept if it does not change
+    if(useDirectStateAccess() && format == _format && width == _width && height == _height && depth == _depth)
+        return;
+    prepareImage();
 #ifdef GLUE_LOGGING
     if(!isBound())
         LOG(DEBUG) << "Texture3D is not bound!";
@@ -42,8 +58,8 @@ void GlTexture3D::resize(GlTexture::InternalFormat format, int width, int height
     _height = height;
     _depth = depth;
     // disable default midmap levels
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_BASE_LEVEL, 0));
-    GL_SAFE_CALL(glTexParameteri(mapTextureType(type()), GL_TEXTURE_MAX_LEVEL, 0));
+    setParameter(GL_TEXTURE_BASE_LEVEL, 0);
+    setParameter(GL_TEXTURE_MAX_LEVEL, 0);
 }
 
 int GlTexture3D::width()
@@ -63,8 +79,6 @@ int GlTexture3D::depth()
 
 bool GlTexture3D::isBound() const
 {
-    GLint currentId = -1;
-    GL_SAFE_CALL(glGetIntegerv(GL_TEXTURE_BINDING_3D, &currentId));
-    return currentId == (GLint)_id;
+    return GlState::current().isTextureBound(type(), _id);
 }
 
@@ -0,0 +1,38 @@
+#include "glue/GlUniformRing.h"
+#include "glue/GlInternal.h"
+
+#include <cassert>
+#include <cstring>
+
+GlUniformRing::GlUniformRing():
+    GlStreamBuffer(Target::Uniform)
+{
+
+}
+
+size_t GlUniformRing::offsetAlignment()
+{
+    // the alignment is the same for all contexts of an implementation
+    static size_t alignment = 0;
+    if(alignment == 0)
+    {
+        GLint value = 0;
+        GL_SAFE_CALL(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value));
+        alignment = value > 0 ? static_cast<size_t>(value) : 256;
+    }
+    return alignment;
+}
+
+GlStreamBuffer::Allocation GlUniformRing::push(const void* data, size_t size)
+{
+    Allocation allocation = allocate((size + 15) / 16 * 16, offsetAlignment());
+    if(allocation.data)
+        std::memcpy(allocation.data, data, size);
+    return allocation;
+}
+
+void GlUniformRing::bindRange(unsigned int index, const Allocation& allocation)
+{
+    assert(allocation.data && allocation.size > 0);
+    GlBuffer::bindRange(index, allocation.offset, allocation.size);
+}
@@ -0,0 +1,92 @@
+#include "glue/GlUtils.h"
+
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace GlUtils
+{
+#ifdef _WIN32
+    mapped_file::mapped_file(const std::string& path):
+        _data(nullptr),
+        _size(0),
+        _file(INVALID_HANDLE_VALUE),
+        _mapping(nullptr)
+    {
+        _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(_file == INVALID_HANDLE_VALUE)
+            return;
+
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(_file, &size) || size.QuadPart == 0)
+            return;
+
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(!_mapping)
+            return;
+
+        _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if(_data)
+            _size = static_cast<size_t>(size.QuadPart);
+    }
+
+    mapped_file::~mapped_file()
+    {
+        if(_data)
+            UnmapViewOfFile(_data);
+        if(_mapping)
+            CloseHandle(_mapping);
+        if(_file != INVALID_HANDLE_VALUE)
+            CloseHandle(_file);
+    }
+#else
+    mapped_file::mapped_file(const std::string& path):
+        _data(nullptr),
+        _size(0)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return;
+
+        struct stat info;
+        if(fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED)
+            {
+                _data = static_cast<const char*>(data);
+                _size = static_cast<size_t>(info.st_size);
+            }
+        }
+        // the mapping stays valid after closing the file
+        close(fd);
+    }
+
+    mapped_file::~mapped_file()
+    {
+        if(_data)
+            munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+
+    bool read_file(const std::string& path, std::string& contents)
+    {
+        mapped_file file(path);
+        if(file)
+        {
+            contents.assign(file.begin(), file.end());
+            return true;
+        }
+
+        // mapping fails for empty files as well
+        contents.clear();
+        return std::ifstream(path).is_open();
+    }
+}
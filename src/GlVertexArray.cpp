@@ -1,57 +1,233 @@
 #include "glue/GlVertexArray.h"
+#include "glue/GlVertexLayout.h"
+#include "glue/GlState.h"
 #include "glue/GlInternal.h"
+#include <algorithm>
+#include <cassert>
 
 GlVertexArray::GlVertexArray(bool autoEnableAttributes):
 	_id(0),
     _autoEnableAttributes(autoEnableAttributes),
     _numVertices(0),
     _numIndices(0),
-    _indexType(GlIndexBuffer::UCHAR)
+    _indexType(GlIndexBuffer::UCHAR),
+    _instanceBuffer(nullptr)
 {
-	GL_SAFE_CALL(glGenVertexArrays(1, &_id));
+    if(useDirectStateAccess())
+    {
+        GL_SAFE_CALL(glCreateVertexArrays(1, &_id));
+    }
+    else
+    {
+        GL_SAFE_CALL(glGenVertexArrays(1, &_id));
+    }
 }
 
 GlVertexArray::~GlVertexArray()
 {
 	GL_SAFE_CALL(glDeleteVertexArrays(1, &_id));
+    GlState::current().vertexArrayDeleted(_id);
 }
 
 void GlVertexArray::bind()
 {
-	GL_SAFE_CALL(glBindVertexArray(_id));
+    GlState::current().bindVertexArray(_id);
 }
 
 void GlVertexArray::release()
 {
-    GL_SAFE_CALL(glBindVertexArray(0));
+    GlState::current().bindVertexArray(0);
 }
 
 bool GlVertexArray::isBound() const
 {
-    GLint currentId = -1;
-    GL_SAFE_CALL(glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &currentId));
-    return currentId == (GLint)_id;
+    return GlState::current().isVertexArrayBound(_id);
 }
 
 void GlVertexArray::setVertexData(GlVertexBuffer& vbo)
+{
+    setVertexStream(0, vbo, 0);
+}
+
+void GlVertexArray::setVertexStream(unsigned int stream, GlVertexBuffer& vbo, unsigned int firstIndex, unsigned int divisor)
 {
 #ifdef GLUE_LOGGING
-    if(!vbo.isBound()) LOG(DEBUG) << "VertexBuffer is not bound!";
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
 #endif
 
     vbo.bind();
 
+    if(_streams.size() <= stream)
+        _streams.resize(stream + 1, VertexStream{nullptr, 0, 0, 0});
+
+    // attributes of the replaced stream that are not re-specified would keep reading from the old buffer
+    const auto& old = _streams[stream];
+    for(unsigned int index=old.firstIndex; old.buffer && index<old.firstIndex + old.numAttributes; ++index)
+    {
+        if(index < firstIndex || index >= firstIndex + vbo.numAttributes())
+            disableAttribute(index);
+    }
+
+    _streams[stream] = VertexStream{&vbo, firstIndex, static_cast<unsigned int>(vbo.numAttributes()), divisor};
+
+#ifdef GLUE_LOGGING
+    for(size_t s=0; s<_streams.size(); ++s)
+    {
+        const auto& other = _streams[s];
+        if(s != stream && other.buffer && firstIndex < other.firstIndex + other.numAttributes && other.firstIndex < firstIndex + vbo.numAttributes())
+            LOG(WARNING) << "Attribute indices of vertex stream " << stream << " overlap with stream " << s;
+    }
+#endif
+
 	for(size_t a=0; a<vbo.numAttributes(); ++a)
 	{
         // set the layout of each attribute
-		auto attribute = vbo.attribute(a);
-        GL_SAFE_CALL(glVertexAttribPointer(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), attribute.normalized, attribute.stride, (void*)((char*)0 + attribute.pointer)));
-        if(_autoEnableAttributes)
-            enableAttribute(a);
+        auto attribute = vbo.attribute(a);
+        attribute.index += firstIndex;
+        attribute.divisor = divisor;
+        setAttribute(attribute);
 	}
-    // only store the number of vertices in the VBO
-    // the VBO will be accessed directly by the VAO, so we don't need to bind it before drawing
-    _numVertices = vbo.numVertices();
+
+    // only store the number of vertices in the VBOs
+    // the VBOs will be accessed directly by the VAO, so we don't need to bind them before drawing
+    bool first = true;
+    for(const auto& s: _streams)
+    {
+        if(!s.buffer || s.divisor != 0)
+            continue;
+        _numVertices = first ? s.buffer->numVertices() : std::min(_numVertices, s.buffer->numVertices());
+        first = false;
+    }
+}
+
+void GlVertexArray::setVertexData(GlBuffer& vbo, const std::vector<GlVertexBuffer::VertexAttribute>& attributes)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    vbo.bind();
+
+    for(const auto& attribute: attributes)
+        setAttribute(attribute);
+    _numVertices = 0;
+}
+
+void GlVertexArray::setInstanceData(GlVertexBuffer& vbo, unsigned int firstIndex, unsigned int divisor)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    vbo.bind();
+
+    _instanceBuffer = &vbo;
+    _instanceAttributes.clear();
+    for(size_t a=0; a<vbo.numAttributes(); ++a)
+    {
+        auto attribute = vbo.attribute(a);
+        attribute.index += firstIndex;
+        attribute.divisor = divisor;
+        setAttribute(attribute);
+        _instanceAttributes.push_back(attribute);
+    }
+}
+
+void GlVertexArray::setAttributeDivisor(unsigned int index, unsigned int divisor)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    GL_SAFE_CALL(glVertexAttribDivisor(index, divisor));
+}
+
+void GlVertexArray::setVertexFormat(const std::vector<GlVertexBuffer::VertexAttribute>& attributes, unsigned int binding)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    if(GLAD_GL_ARB_vertex_attrib_binding)
+    {
+        for(const auto& attribute: attributes)
+        {
+            if(attribute.integer)
+            {
+                GL_SAFE_CALL(glVertexAttribIFormat(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), (GLuint)attribute.pointer));
+            }
+            else
+            {
+                GL_SAFE_CALL(glVertexAttribFormat(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), attribute.normalized, (GLuint)attribute.pointer));
+            }
+            GL_SAFE_CALL(glVertexAttribBinding(attribute.index, binding));
+            if(_autoEnableAttributes)
+                enableAttribute(attribute.index);
+        }
+    }
+    else
+    {
+        if(_bindingFormats.size() <= binding)
+            _bindingFormats.resize(binding + 1);
+        _bindingFormats[binding] = attributes;
+        for(const auto& attribute: attributes)
+        {
+            if(_autoEnableAttributes)
+                enableAttribute(attribute.index);
+        }
+    }
+}
+
+void GlVertexArray::bindVertexBuffer(unsigned int binding, GlBuffer& buffer, size_t offset, size_t stride)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    // a stride of 0 repeats the first vertex with glBindVertexBuffer but means tightly packed with glVertexAttribPointer
+    assert(stride > 0);
+
+    if(GLAD_GL_ARB_vertex_attrib_binding)
+    {
+        GL_SAFE_CALL(glBindVertexBuffer(binding, buffer.id(), (GLintptr)offset, (GLsizei)stride));
+        return;
+    }
+
+    assert(binding < _bindingFormats.size());
+
+    // re-specify the stored format with the new buffer and offset
+    buffer.bind();
+    for(const auto& attribute: _bindingFormats[binding])
+    {
+        if(attribute.integer)
+        {
+            GL_SAFE_CALL(glVertexAttribIPointer(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), (GLsizei)stride, (void*)((char*)0 + attribute.pointer + offset)));
+        }
+        else
+        {
+            GL_SAFE_CALL(glVertexAttribPointer(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), attribute.normalized, (GLsizei)stride, (void*)((char*)0 + attribute.pointer + offset)));
+        }
+    }
+}
+
+void GlVertexArray::setBindingDivisor(unsigned int binding, unsigned int divisor)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    if(GLAD_GL_ARB_vertex_attrib_binding)
+    {
+        GL_SAFE_CALL(glVertexBindingDivisor(binding, divisor));
+        return;
+    }
+
+    assert(binding < _bindingFormats.size());
+    for(auto& attribute: _bindingFormats[binding])
+    {
+        attribute.divisor = divisor;
+        GL_SAFE_CALL(glVertexAttribDivisor(attribute.index, divisor));
+    }
 }
 
 void GlVertexArray::setIndexBuffer(GlIndexBuffer& ibo)
@@ -68,6 +244,18 @@ void GlVertexArray::setIndexBuffer(GlIndexBuffer& ibo)
     _indexType = ibo.indexType();
 }
 
+void GlVertexArray::setIndexBuffer(GlBuffer& ibo, GlIndexBuffer::IndexType type)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    ibo.bind();
+
+    _numIndices = 0;
+    _indexType = type;
+}
+
 void GlVertexArray::draw(GlVertexArray::Primitive mode)
 {
 #ifdef GLUE_LOGGING
@@ -77,6 +265,15 @@ void GlVertexArray::draw(GlVertexArray::Primitive mode)
     GL_SAFE_CALL(glDrawArrays(mapVertexArrayPrimitive(mode), 0, _numVertices));
 }
 
+void GlVertexArray::draw(GlVertexArray::Primitive mode, size_t first, size_t count)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    GL_SAFE_CALL(glDrawArrays(mapVertexArrayPrimitive(mode), (GLint)first, (GLsizei)count));
+}
+
 void GlVertexArray::drawElements(GlVertexArray::Primitive mode)
 {
 #ifdef GLUE_LOGGING
@@ -86,6 +283,159 @@ void GlVertexArray::drawElements(GlVertexArray::Primitive mode)
     GL_SAFE_CALL(glDrawElements(mapVertexArrayPrimitive(mode), _numIndices, mapIndexBufferIndexType(_indexType), 0));
 }
 
+void GlVertexArray::drawElements(GlVertexArray::Primitive mode, size_t count, size_t firstIndex, int baseVertex)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    const size_t offset = firstIndex * GlIndexBuffer::indexSize(_indexType);
+    GL_SAFE_CALL(glDrawElementsBaseVertex(mapVertexArrayPrimitive(mode), (GLsizei)count, mapIndexBufferIndexType(_indexType), (void*)((char*)0 + offset), baseVertex));
+}
+
+void GlVertexArray::drawRangeElements(GlVertexArray::Primitive mode, unsigned int minIndex, unsigned int maxIndex, size_t count, size_t firstIndex, int baseVertex)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    const size_t offset = firstIndex * GlIndexBuffer::indexSize(_indexType);
+    GL_SAFE_CALL(glDrawRangeElementsBaseVertex(mapVertexArrayPrimitive(mode), minIndex, maxIndex, (GLsizei)count, mapIndexBufferIndexType(_indexType), (void*)((char*)0 + offset), baseVertex));
+}
+
+void GlVertexArray::drawInstanced(GlVertexArray::Primitive mode, size_t instanceCount, unsigned int baseInstance)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    submitArrays(mode, 0, _numVertices, instanceCount, baseInstance);
+}
+
+void GlVertexArray::drawElementsInstanced(GlVertexArray::Primitive mode, size_t instanceCount, unsigned int baseInstance)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    submitElements(mode, _numIndices, 0, 0, instanceCount, baseInstance);
+}
+
+void GlVertexArray::multiDraw(GlVertexArray::Primitive mode, GlUtils::array_view<int> first, GlUtils::array_view<int> counts)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    assert(first.size() == counts.size());
+    GL_SAFE_CALL(glMultiDrawArrays(mapVertexArrayPrimitive(mode), first.data(), counts.data(), (GLsizei)counts.size()));
+}
+
+void GlVertexArray::multiDrawElements(GlVertexArray::Primitive mode, GlUtils::array_view<int> counts, GlUtils::array_view<unsigned int> firstIndices, GlUtils::array_view<int> baseVertices)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    assert(firstIndices.size() == counts.size());
+    assert(baseVertices.empty() || baseVertices.size() == counts.size());
+
+    // the GL expects byte offsets into the index buffer
+    const size_t indexSize = GlIndexBuffer::indexSize(_indexType);
+    std::vector<const void*> offsets(firstIndices.size());
+    for(size_t i=0; i<firstIndices.size(); ++i)
+        offsets[i] = (char*)0 + firstIndices[i] * indexSize;
+
+    const GLenum type = mapIndexBufferIndexType(_indexType);
+    if(baseVertices.empty())
+    {
+        GL_SAFE_CALL(glMultiDrawElements(mapVertexArrayPrimitive(mode), counts.data(), type, offsets.data(), (GLsizei)counts.size()));
+    }
+    else
+    {
+        GL_SAFE_CALL(glMultiDrawElementsBaseVertex(mapVertexArrayPrimitive(mode), counts.data(), type, offsets.data(), (GLsizei)counts.size(), baseVertices.data()));
+    }
+}
+
+void GlVertexArray::multiDrawIndirect(GlVertexArray::Primitive mode, GlIndirectBuffer& indirect)
+{
+    multiDrawIndirect(mode, indirect, 0, indirect.numCommands());
+}
+
+void GlVertexArray::multiDrawIndirect(GlVertexArray::Primitive mode, GlIndirectBuffer& indirect, size_t firstCommand, size_t numCommands)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    typedef GlIndirectBuffer::DrawArraysCommand Command;
+    const size_t offset = firstCommand * sizeof(Command);
+
+    indirect.bind();
+    if(GLAD_GL_ARB_multi_draw_indirect)
+    {
+        GL_SAFE_CALL(glMultiDrawArraysIndirect(mapVertexArrayPrimitive(mode), (char*)0 + offset, (GLsizei)numCommands, sizeof(Command)));
+    }
+    else if(GLAD_GL_ARB_draw_indirect)
+    {
+        for(size_t c=0; c<numCommands; ++c)
+        {
+            GL_SAFE_CALL(glDrawArraysIndirect(mapVertexArrayPrimitive(mode), (char*)0 + offset + c * sizeof(Command)));
+        }
+    }
+    else
+    {
+        // without ARB_draw_indirect the commands are only stored on the CPU
+        assert(firstCommand + numCommands <= indirect.numCommands());
+        auto commands = static_cast<const Command*>(indirect.clientCommands());
+        for(size_t c=firstCommand; c<firstCommand + numCommands; ++c)
+        {
+            const Command& command = commands[c];
+            submitArrays(mode, command.first, command.count, command.instanceCount, command.baseInstance);
+        }
+    }
+}
+
+void GlVertexArray::multiDrawElementsIndirect(GlVertexArray::Primitive mode, GlIndirectBuffer& indirect)
+{
+    multiDrawElementsIndirect(mode, indirect, 0, indirect.numCommands());
+}
+
+void GlVertexArray::multiDrawElementsIndirect(GlVertexArray::Primitive mode, GlIndirectBuffer& indirect, size_t firstCommand, size_t numCommands)
+{
+#ifdef GLUE_LOGGING
+    if(!isBound()) LOG(DEBUG) << "VertexArray is not bound!";
+#endif
+
+    typedef GlIndirectBuffer::DrawElementsCommand Command;
+    const size_t offset = firstCommand * sizeof(Command);
+    const GLenum type = mapIndexBufferIndexType(_indexType);
+
+    indirect.bind();
+    if(GLAD_GL_ARB_multi_draw_indirect)
+    {
+        GL_SAFE_CALL(glMultiDrawElementsIndirect(mapVertexArrayPrimitive(mode), type, (char*)0 + offset, (GLsizei)numCommands, sizeof(Command)));
+    }
+    else if(GLAD_GL_ARB_draw_indirect)
+    {
+        for(size_t c=0; c<numCommands; ++c)
+        {
+            GL_SAFE_CALL(glDrawElementsIndirect(mapVertexArrayPrimitive(mode), type, (char*)0 + offset + c * sizeof(Command)));
+        }
+    }
+    else
+    {
+        // without ARB_draw_indirect the commands are only stored on the CPU
+        assert(firstCommand + numCommands <= indirect.numCommands());
+        auto commands = static_cast<const Command*>(indirect.clientCommands());
+        for(size_t c=firstCommand; c<firstCommand + numCommands; ++c)
+        {
+            const Command& command = commands[c];
+            submitElements(mode, command.count, command.firstIndex, command.baseVertex, command.instanceCount, command.baseInstance);
+        }
+    }
+}
+
 void GlVertexArray::enableAttribute(unsigned int index)
 {
 #ifdef GLUE_LOGGING
@@ -104,3 +454,71 @@ void GlVertexArray::disableAttribute(unsigned int index)
 	GL_SAFE_CALL(glDisableVertexAttribArray(index));
 }
 
+void GlVertexArray::setAttribute(const GlVertexBuffer::VertexAttribute& attribute, size_t offset)
+{
+    if(attribute.integer)
+    {
+        GL_SAFE_CALL(glVertexAttribIPointer(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), attribute.stride, (void*)((char*)0 + attribute.pointer + offset)));
+    }
+    else
+    {
+        GL_SAFE_CALL(glVertexAttribPointer(attribute.index, attribute.size, mapVertexAttributeType(attribute.type), attribute.normalized, attribute.stride, (void*)((char*)0 + attribute.pointer + offset)));
+    }
+    GL_SAFE_CALL(glVertexAttribDivisor(attribute.index, attribute.divisor));
+    if(_autoEnableAttributes)
+        enableAttribute(attribute.index);
+}
+
+void GlVertexArray::setInstanceOffset(unsigned int baseInstance)
+{
+    if(!_instanceBuffer)
+        return;
+
+    // the base instance is added after the divisor is applied, so every attribute skips baseInstance values
+    _instanceBuffer->bind();
+    for(const auto& attribute: _instanceAttributes)
+    {
+        const size_t stride = attribute.stride != 0 ? attribute.stride : GlUtils::detail::attributeSize(attribute.type, attribute.size);
+        setAttribute(attribute, baseInstance * stride);
+    }
+}
+
+void GlVertexArray::submitArrays(Primitive mode, size_t first, size_t count, size_t instanceCount, unsigned int baseInstance)
+{
+    const GLenum primitive = mapVertexArrayPrimitive(mode);
+    if(baseInstance == 0)
+    {
+        GL_SAFE_CALL(glDrawArraysInstanced(primitive, (GLint)first, (GLsizei)count, (GLsizei)instanceCount));
+    }
+    else if(GLAD_GL_ARB_base_instance)
+    {
+        GL_SAFE_CALL(glDrawArraysInstancedBaseInstance(primitive, (GLint)first, (GLsizei)count, (GLsizei)instanceCount, baseInstance));
+    }
+    else
+    {
+        setInstanceOffset(baseInstance);
+        GL_SAFE_CALL(glDrawArraysInstanced(primitive, (GLint)first, (GLsizei)count, (GLsizei)instanceCount));
+        setInstanceOffset(0);
+    }
+}
+
+void GlVertexArray::submitElements(Primitive mode, size_t count, size_t firstIndex, int baseVertex, size_t instanceCount, unsigned int baseInstance)
+{
+    const GLenum primitive = mapVertexArrayPrimitive(mode);
+    const GLenum type = mapIndexBufferIndexType(_indexType);
+    const void* offset = (char*)0 + firstIndex * GlIndexBuffer::indexSize(_indexType);
+    if(baseInstance == 0)
+    {
+        GL_SAFE_CALL(glDrawElementsInstancedBaseVertex(primitive, (GLsizei)count, type, offset, (GLsizei)instanceCount, baseVertex));
+    }
+    else if(GLAD_GL_ARB_base_instance)
+    {
+        GL_SAFE_CALL(glDrawElementsInstancedBaseVertexBaseInstance(primitive, (GLsizei)count, type, offset, (GLsizei)instanceCount, baseVertex, baseInstance));
+    }
+    else
+    {
+        setInstanceOffset(baseInstance);
+        GL_SAFE_CALL(glDrawElementsInstancedBaseVertex(primitive, (GLsizei)count, type, offset, (GLsizei)instanceCount, baseVertex));
+        setInstanceOffset(0);
+    }
+}
@@ -1,20 +1,26 @@
 #include "glue/GlVertexBuffer.h"
+#include "glue/GlInternal.h"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 #ifdef GLUE_QT
 #include <QtGui/QVector2D>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector4D>
 #endif
 
-GlVertexBuffer::VertexAttribute::VertexAttribute(unsigned int i, int s, Type t, bool normalized):
+GlVertexBuffer::VertexAttribute::VertexAttribute(unsigned int i, int s, Type t, bool normalized, bool integer):
 	index(i),
     size(s),
 	stride(0),
     pointer(0),
     type(t),
-    normalized(normalized)
+    normalized(normalized),
+    integer(integer),
+    divisor(0)
 {
 
 }
@@ -48,58 +54,80 @@ GlVertexBuffer::VertexAttribute GlVertexBuffer::attribute(unsigned int index) co
 	}
 }
 
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<float>(unsigned int index)
+void GlVertexBuffer::setInterleavedData(Usage usage, const void* vertices, size_t numVertices, size_t stride, const std::vector<VertexAttribute>& layout)
 {
-    return VertexAttribute(index, 1, VertexAttribute::Float);
+    _attributes = layout;
+    for(auto& attribute: _attributes)
+    {
+        if(attribute.stride == 0)
+            attribute.stride = stride;
+        assert(attribute.pointer < stride);
+    }
+    _numVertices = numVertices;
+
+    GlBuffer::setData(usage, vertices, numVertices * stride);
 }
 
-#ifdef GLUE_GLM
-static_assert(sizeof(glm::vec2) == sizeof(float) * 2, "glm vector type not aligned correctly");
-static_assert(sizeof(glm::vec3) == sizeof(float) * 3, "glm vector type not aligned correctly");
-static_assert(sizeof(glm::vec4) == sizeof(float) * 4, "glm vector type not aligned correctly");
-
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<glm::vec2>(unsigned int index)
+// Copies count values of a fixed size to dst, with stride bytes between two values in dst.
+// The fixed size lets the compiler replace the memcpy with a single (vector) load and store.
+template<size_t Size>
+static void copyStrided(char* dst, size_t stride, const char* src, size_t count)
 {
-    return VertexAttribute(index, 2, VertexAttribute::Float);
+    for(size_t i=0; i<count; ++i)
+    {
+        std::memcpy(dst, src, Size);
+        dst += stride;
+        src += Size;
+    }
 }
 
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<glm::vec3>(unsigned int index)
+static void copyStrided(char* dst, size_t stride, const char* src, size_t size, size_t count)
 {
-    return VertexAttribute(index, 3, VertexAttribute::Float);
+    switch(size)
+    {
+    case 4: copyStrided<4>(dst, stride, src, count); break;   // float
+    case 8: copyStrided<8>(dst, stride, src, count); break;   // vec2
+    case 12: copyStrided<12>(dst, stride, src, count); break; // vec3
+    case 16: copyStrided<16>(dst, stride, src, count); break; // vec4
+    default:
+        for(size_t i=0; i<count; ++i)
+            std::memcpy(dst + i*stride, src + i*size, size);
+    }
 }
 
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<glm::vec4>(unsigned int index)
+void GlVertexBuffer::writeInterleaved(const std::vector<InterleavedSource>& sources, size_t stride)
 {
-    return VertexAttribute(index, 4, VertexAttribute::Float);
-}
+    if(_numVertices == 0)
+        return;
+
+    char* dst = static_cast<char*>(map(0, _size, MapWrite | MapInvalidateBuffer));
+    if(!dst)
+    {
+#ifdef GLUE_LOGGING
+        LOG(WARNING) << "VertexBuffer could not be mapped";
 #endif
-
-#ifdef GLUE_QT
-static_assert(sizeof(QVector2D) == sizeof(float) * 2, "QVector2D not aligned correctly");
-static_assert(sizeof(QVector3D) == sizeof(float) * 3, "QVector3D not aligned correctly");
-static_assert(sizeof(QVector4D) == sizeof(float) * 4, "QVector4D not aligned correctly");
-
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<QVector2D>(unsigned int index)
-{
-    return VertexAttribute(index, 2, VertexAttribute::Float);
-}
-
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<QVector3D>(unsigned int index)
-{
-    return VertexAttribute(index, 3, VertexAttribute::Float);
-}
-
-template<>
-GlVertexBuffer::VertexAttribute GlVertexBuffer::createAttribute<QVector4D>(unsigned int index)
-{
-    return VertexAttribute(index, 4, VertexAttribute::Float);
-}
-
+        return;
+    }
+
+    // Mapped buffer memory is often write-combined and should only be written sequentially.
+    // The vertices are therefore interleaved in small chunks on the stack and then copied in one go.
+    alignas(16) char staging[16*1024];
+    const size_t chunkSize = std::max<size_t>(sizeof(staging) / stride, 1);
+    for(size_t first=0; first<_numVertices; first+=chunkSize)
+    {
+        const size_t count = std::min(chunkSize, _numVertices - first);
+        // vertices larger than the staging memory are written directly
+        char* chunk = stride <= sizeof(staging) ? staging : dst + first*stride;
+        for(const auto& source: sources)
+            copyStrided(chunk + source.offset, stride, source.data + first*source.size, source.size, count);
+        if(chunk == staging)
+            std::memcpy(dst + first*stride, staging, count * stride);
+    }
+
+    if(!unmap())
+    {
+#ifdef GLUE_LOGGING
+        LOG(WARNING) << "VertexBuffer data got corrupted while mapped";
 #endif
-
+    }
+}
@@ -0,0 +1,180 @@
+#include "glue/GlVertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GLUE_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        const uint32_t sign = (f >> 16) & 0x8000;
+        const uint32_t abs = f & 0x7fffffff;
+
+        // infinity or NaN (keep NaNs quiet)
+        if(abs >= 0x7f800000)
+            return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+        // too large, rounds to infinity
+        if(abs >= 0x477ff000)
+            return sign | 0x7c00;
+        // denormal or zero: the value is a multiple of 2^-24
+        if(abs < 0x38800000)
+        {
+            float absValue;
+            std::memcpy(&absValue, &abs, sizeof(absValue));
+            return sign | static_cast<uint16_t>(std::nearbyint(absValue * 16777216.0f));
+        }
+        // normal: rebias the exponent and round the mantissa to nearest even
+        uint32_t h = (abs - 0x38000000) >> 13;
+        const uint32_t rest = abs & 0x1fff;
+        if(rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+            ++h;
+        return static_cast<uint16_t>(sign | h);
+    }
+
+    inline float clamp(float value, float low, float high)
+    {
+        return std::min(std::max(value, low), high);
+    }
+
+    inline float signNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+}
+
+namespace GlUtils
+{
+    void pack_half(const float* src, size_t count, uint16_t* dst)
+    {
+        size_t i = 0;
+#ifdef __F16C__
+        for(; i+4 <= count; i+=4)
+        {
+            __m128i h = _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), h);
+        }
+#endif
+        for(; i<count; ++i)
+            dst[i] = floatToHalf(src[i]);
+    }
+
+    void pack_snorm16(const float* src, size_t count, int16_t* dst)
+    {
+        size_t i = 0;
+#ifdef GLUE_SSE2
+        const __m128 low = _mm_set1_ps(-1.0f);
+        const __m128 high = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        for(; i+8 <= count; i+=8)
+        {
+            __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), low), high);
+            __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), low), high);
+            // convert with round to nearest and pack to 16 bit
+            __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)), _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#endif
+        for(; i<count; ++i)
+            dst[i] = static_cast<int16_t>(std::lrint(clamp(src[i], -1.0f, 1.0f) * 32767.0f));
+    }
+
+    void pack_unorm16(const float* src, size_t count, uint16_t* dst)
+    {
+        for(size_t i=0; i<count; ++i)
+            dst[i] = static_cast<uint16_t>(std::lrint(clamp(src[i], 0.0f, 1.0f) * 65535.0f));
+    }
+
+    void pack_snorm8(const float* src, size_t count, int8_t* dst)
+    {
+        size_t i = 0;
+#ifdef GLUE_SSE2
+        const __m128 low = _mm_set1_ps(-1.0f);
+        const __m128 high = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(127.0f);
+        for(; i+16 <= count; i+=16)
+        {
+            __m128i v[4];
+            for(int j=0; j<4; ++j)
+            {
+                __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4*j), low), high);
+                v[j] = _mm_cvtps_epi32(_mm_mul_ps(f, scale));
+            }
+            __m128i packed = _mm_packs_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#endif
+        for(; i<count; ++i)
+            dst[i] = static_cast<int8_t>(std::lrint(clamp(src[i], -1.0f, 1.0f) * 127.0f));
+    }
+
+    void pack_unorm8(const float* src, size_t count, uint8_t* dst)
+    {
+        size_t i = 0;
+#ifdef GLUE_SSE2
+        const __m128 low = _mm_set1_ps(0.0f);
+        const __m128 high = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        for(; i+16 <= count; i+=16)
+        {
+            __m128i v[4];
+            for(int j=0; j<4; ++j)
+            {
+                __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4*j), low), high);
+                v[j] = _mm_cvtps_epi32(_mm_mul_ps(f, scale));
+            }
+            // all values are in [0,255], so the signed 16 bit pack does not saturate
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#endif
+        for(; i<count; ++i)
+            dst[i] = static_cast<uint8_t>(std::lrint(clamp(src[i], 0.0f, 1.0f) * 255.0f));
+    }
+
+    void pack_snorm_2_10_10_10(const float* xyz, size_t count, packed_snorm* dst, float w)
+    {
+        const uint32_t packedW = static_cast<uint32_t>(std::lrint(clamp(w, -1.0f, 1.0f))) & 0x3;
+        for(size_t i=0; i<count; ++i)
+        {
+            const float* v = xyz + 3*i;
+            const uint32_t x = static_cast<uint32_t>(std::lrint(clamp(v[0], -1.0f, 1.0f) * 511.0f)) & 0x3ff;
+            const uint32_t y = static_cast<uint32_t>(std::lrint(clamp(v[1], -1.0f, 1.0f) * 511.0f)) & 0x3ff;
+            const uint32_t z = static_cast<uint32_t>(std::lrint(clamp(v[2], -1.0f, 1.0f) * 511.0f)) & 0x3ff;
+            dst[i].value = x | (y << 10) | (z << 20) | (packedW << 30);
+        }
+    }
+
+    void pack_octahedral(const float* xyz, size_t count, snorm16x2* dst)
+    {
+        for(size_t i=0; i<count; ++i)
+        {
+            const float* v = xyz + 3*i;
+            // project onto the octahedron |x|+|y|+|z| = 1
+            const float l1 = std::abs(v[0]) + std::abs(v[1]) + std::abs(v[2]);
+            float x = l1 > 0.0f ? v[0] / l1 : 0.0f;
+            float y = l1 > 0.0f ? v[1] / l1 : 0.0f;
+            // fold the lower hemisphere over the diagonals
+            if(v[2] < 0.0f)
+            {
+                const float foldedX = (1.0f - std::abs(y)) * signNotZero(x);
+                const float foldedY = (1.0f - std::abs(x)) * signNotZero(y);
+                x = foldedX;
+                y = foldedY;
+            }
+            dst[i].x = static_cast<int16_t>(std::lrint(clamp(x, -1.0f, 1.0f) * 32767.0f));
+            dst[i].y = static_cast<int16_t>(std::lrint(clamp(y, -1.0f, 1.0f) * 32767.0f));
+        }
+    }
+}